@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "framer.h"
+#include "hitmap.h"
+#include "memstats.h"
+#include "outbuffer.h"
+#include "protocol.h"
+#include "ship.h"
+#include "targeting.h"
+#include "placement.h"
+
+// Microbenchmarks of the hot paths of the core library. Each one reports nanoseconds and allocations per operation.
+// Usage: battleship_bench [<iterations>]
+
+#define NUMBER_OF_BENCH_SHIPS 5
+#define BENCH_GRID_SIZE 10
+
+static Ship* ships[NUMBER_OF_BENCH_SHIPS];
+static Fleet fleet;
+static Arena arena;
+static Hitmap* hitmap;
+static OutputBuffer out;
+static MessageFramer framer;
+static FleetPlacer placer;
+static volatile int sink; // Keeps results alive so that the benchmarked calls aren't optimized away
+
+// Makes a straight ship of length parts pointing up, like the ones of resources/fleet.txt.
+static Ship* makeStraightShip(const char* name, int index, int length) {
+	Ship* ship = makeShip(name, index, SHIP_MATRIX_SIZE, SHIP_MATRIX_SIZE);
+	int top = (SHIP_MATRIX_SIZE - length) / 2;
+	for(int y = 0; y < length; y++) ship->matrix[top + y][SHIP_MATRIX_SIZE / 2] = y == 0 ? 'F' : y == length - 1 ? 'B' : 'M';
+	buildShipOrientations(ship);
+	return ship;
+}
+
+static void setUp() {
+	const char* names[NUMBER_OF_BENCH_SHIPS] = { "destroyer", "submarine", "cruiser", "battleship", "carrier" };
+	const int lengths[NUMBER_OF_BENCH_SHIPS] = { 2, 3, 3, 4, 5 };
+	clearFleet(&fleet);
+	for(int i = 0; i < NUMBER_OF_BENCH_SHIPS; i++) {
+		ships[i] = makeStraightShip(names[i], i, lengths[i]);
+		ships[i]->x = i * 2 - 1;
+		ships[i]->y = 2;
+		if(i < NUMBER_OF_BENCH_SHIPS - 1) addShipToFleet(&fleet, ships[i]);
+	}
+	ships[NUMBER_OF_BENCH_SHIPS - 1]->x = 6;
+	initArena(&arena, MATCH_ARENA_SIZE);
+	hitmap = initHitmap(&arena);
+	initOutputBuffer(&out, NULL);
+	initFramer(&framer);
+	Bitboard grid;
+	makeBoardMask(&grid, BENCH_GRID_SIZE, BENCH_GRID_SIZE);
+	initFleetPlacer(&placer, ships, NUMBER_OF_BENCH_SHIPS, &grid);
+}
+
+static void benchRotateShip(long i) {
+	changeShipRotation(ships[i % NUMBER_OF_BENCH_SHIPS]);
+	sink += ships[i % NUMBER_OF_BENCH_SHIPS]->rotation;
+}
+
+static void benchFleetCollision(long i) {
+	Ship* ship = ships[NUMBER_OF_BENCH_SHIPS - 1];
+	ship->x = (int) (i % 8) - 2;
+	ship->y = (int) (i / 8 % 8) - 2;
+	sink += findFleetCollision(&fleet, ship) != NULL;
+}
+
+static void benchPlacementIndex(long i) {
+	static PlacementIndex index;
+	invalidatePlacementIndex(&index);
+	Bitboard grid;
+	makeBoardMask(&grid, BENCH_GRID_SIZE, BENCH_GRID_SIZE);
+	updatePlacementIndex(&index, &fleet, ships[NUMBER_OF_BENCH_SHIPS - 1], &grid);
+	sink += (int) index.anchors.words[i % BITBOARD_WORDS];
+}
+
+static void benchStringifyShips(long i) {
+	resetOutputBuffer(&out);
+	stringifyShips(&out, ships, NUMBER_OF_BENCH_SHIPS);
+	sink += out.data[i % out.length];
+}
+
+static void benchEncodeTextReady(long i) {
+	resetOutputBuffer(&out);
+	encodeTextReady(&out, ships, NUMBER_OF_BENCH_SHIPS);
+	sink += out.data[i % out.length];
+}
+
+static void benchEncodeBinaryReady(long i) {
+	resetOutputBuffer(&out);
+	encodeBinaryReady(&out, ships, NUMBER_OF_BENCH_SHIPS, BENCH_GRID_SIZE, BENCH_GRID_SIZE);
+	sink += out.data[i % out.length];
+}
+
+// Receives a message through the framer and decodes it, like the network thread does.
+static void receiveMessage(const char* bytes, size_t length, unsigned char binary) {
+	framer.binary = binary;
+	size_t available;
+	char* space = getFramerWriteSpace(&framer, &available);
+	memcpy(space, bytes, length);
+	commitFramerWrite(&framer, length);
+	MessageView message;
+	ServerMessage decoded;
+	while(nextMessage(&framer, &message)) {
+		if(binary) decodeBinaryMessage(message, &decoded);
+		else decodeTextMessage(message, &decoded);
+		sink += decoded.type + decoded.x + decoded.y;
+	}
+}
+
+static void benchParseText(long i) {
+	static const char message[] = "hit_sunk\r\n3 7\r\n\r\n";
+	(void) i;
+	receiveMessage(message, sizeof(message) - 1, 0);
+}
+
+static void benchParseBinary(long i) {
+	static const char frame[] = { 0, 3, BINARY_HIT_SUNK, 3, 7 };
+	(void) i;
+	receiveMessage(frame, sizeof(frame), 1);
+}
+
+static void benchHitmapWrite(long i) {
+	int cell = (int) (i % (BENCH_GRID_SIZE * BENCH_GRID_SIZE));
+	if(cell == 0) resetHitmap(hitmap);
+	setHitmapField(hitmap, cell % BENCH_GRID_SIZE, cell / BENCH_GRID_SIZE, 1 + (char) (i & 1));
+}
+
+static void benchHitmapRead(long i) {
+	int cell = (int) (i % (BENCH_GRID_SIZE * BENCH_GRID_SIZE));
+	sink += getHitmapField(hitmap, cell % BENCH_GRID_SIZE, cell / BENCH_GRID_SIZE);
+}
+
+static void benchHitmapSnapshot(long i) {
+	HitmapBuffer snapshot;
+	sink += getHitmapSnapshot(hitmap, &snapshot) + (int) snapshot.hits.words[i % BITBOARD_WORDS];
+}
+
+// Half-played board: a few misses scattered around and two hits next to each other, so target mode is exercised too.
+static void benchDensityMap(long i) {
+	static DensityMap map;
+	HitmapBuffer hitmap = { 0 };
+	Bitboard grid;
+	makeBoardMask(&grid, BENCH_GRID_SIZE, BENCH_GRID_SIZE);
+	for(int cell = 0; cell < BENCH_GRID_SIZE * BENCH_GRID_SIZE; cell += 7) setBit(&hitmap.misses, cell % BENCH_GRID_SIZE, cell / BENCH_GRID_SIZE);
+	if(i & 1) {
+		setBit(&hitmap.hits, 4, 5);
+		setBit(&hitmap.hits, 5, 5);
+	}
+	computeDensityMap(&map, &hitmap, &grid, (const Ship* const*) ships, NUMBER_OF_BENCH_SHIPS);
+	sink += map.bestX + map.bestY;
+}
+
+static void benchRandomFleet(long i) {
+	static uint64_t rng = 1;
+	FleetLayout layout;
+	sampleRandomFleet(&placer, &layout, &rng);
+	sink += layout.x[i % NUMBER_OF_BENCH_SHIPS];
+}
+
+static void benchScoreFleet(long i) {
+	static uint64_t rng = 1;
+	static FleetLayout layout;
+	if(i % 64 == 0) sampleRandomFleet(&placer, &layout, &rng);
+	sink += scoreFleetLayout(&placer, &layout);
+}
+
+typedef struct {
+	const char* name;
+	void (*run)(long i);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+	{ "rotate ship", benchRotateShip },
+	{ "fleet collision", benchFleetCollision },
+	{ "placement index", benchPlacementIndex },
+	{ "stringify ships", benchStringifyShips },
+	{ "encode text ready", benchEncodeTextReady },
+	{ "encode binary ready", benchEncodeBinaryReady },
+	{ "parse text message", benchParseText },
+	{ "parse binary message", benchParseBinary },
+	{ "hitmap write", benchHitmapWrite },
+	{ "hitmap read", benchHitmapRead },
+	{ "hitmap snapshot", benchHitmapSnapshot },
+	{ "density map", benchDensityMap },
+	{ "random fleet", benchRandomFleet },
+	{ "score fleet", benchScoreFleet }
+};
+
+static double getSeconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+	long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+	if(iterations <= 0) {
+		printf("Usage: %s [<iterations>]\n", argv[0]);
+		exit(1);
+	}
+
+	setUp();
+	printf("%-22s %12s %12s\n", "benchmark", "ns/op", "allocs/op");
+	for(size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+		// Warm up once so that buffers reach their steady-state size before measuring
+		for(long i = 0; i < iterations / 10 + 1; i++) benchmarks[b].run(i);
+
+		size_t allocations = getAllocationCount();
+		double start = getSeconds();
+		for(long i = 0; i < iterations; i++) benchmarks[b].run(i);
+		double elapsed = getSeconds() - start;
+		allocations = getAllocationCount() - allocations;
+		printf("%-22s %12.2f %12.4f\n", benchmarks[b].name, elapsed * 1e9 / iterations, (double) allocations / iterations);
+	}
+
+	freeOutputBuffer(&out);
+	freeArena(&arena);
+	for(int i = 0; i < NUMBER_OF_BENCH_SHIPS; i++) freeShip(ships[i]);
+	return 0;
+}
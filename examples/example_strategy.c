@@ -0,0 +1,174 @@
+#include <stdlib.h>
+#include <string.h>
+#include "strategy.h"
+
+// An example strategy plugin, built against strategy.h only. It places the ships in their own rows from the top-left
+// corner and attacks on diagonals spaced by the shortest ship left, finishing off the ships it has hit first.
+//
+// Client: BattleshipSDLClient -s ./libexample_strategy.so <nickname>
+// Simulator: battleship_sim -l ./libexample_strategy.so
+
+typedef struct {
+	StrategyGame game;
+	uint64_t random;
+	unsigned char sunkShips[64]; // Part counts of the ships sunk so far
+	int sunkCount;
+	int pendingSunk; // Cell of the last attack that sank a ship, or -1; its size is counted on the next turn
+} ExampleState;
+
+static uint64_t nextExampleRandom(ExampleState* state) {
+	state->random ^= state->random << 13;
+	state->random ^= state->random >> 7;
+	state->random ^= state->random << 17;
+	return state->random;
+}
+
+static void* createExample(const StrategyGame* game, uint64_t seed) {
+	ExampleState* state = calloc(1, sizeof(ExampleState));
+	if(state == NULL) return NULL;
+	state->game = *game;
+	state->random = seed | 1;
+	state->pendingSunk = -1;
+	return state;
+}
+
+static void destroyExample(void* state) {
+	free(state);
+}
+
+// Ships go unrotated, one after the other, leaving an empty column between them and moving down when a row is full.
+static int placeExampleFleet(void* data, StrategyPlacement* placements) {
+	ExampleState* state = data;
+	int x = 0, y = 0, rowHeight = 0;
+	for(int i = 0; i < state->game.shipCount; i++) {
+		const StrategyShip* ship = &state->game.ships[i];
+		int top = STRATEGY_SHIP_SIZE, bottom = -1, left = STRATEGY_SHIP_SIZE, right = -1;
+		for(int my = 0; my < STRATEGY_SHIP_SIZE; my++) {
+			for(int mx = 0; mx < STRATEGY_SHIP_SIZE; mx++) {
+				if(ship->matrix[my][mx] == 0) continue;
+				if(my < top) top = my;
+				if(my > bottom) bottom = my;
+				if(mx < left) left = mx;
+				if(mx > right) right = mx;
+			}
+		}
+		int width = right - left + 1, height = bottom - top + 1;
+		if(x + width > state->game.cols) {
+			x = 0;
+			y += rowHeight + 1;
+			rowHeight = 0;
+		}
+		if(y + height > state->game.rows) return 0;
+		placements[i].rotation = 0;
+		placements[i].x = x - left;
+		placements[i].y = y - top;
+		x += width + 1;
+		if(height > rowHeight) rowHeight = height;
+	}
+	return 1;
+}
+
+// The shortest ship that hasn't been sunk yet, assuming the sunk ones were the first with their part count.
+static int getShortestShipLeft(ExampleState* state) {
+	unsigned char used[64] = { 0 };
+	int shortest = 0;
+	for(int i = 0; i < state->game.shipCount && i < 64; i++) {
+		int partCount = state->game.ships[i].partCount;
+		int sunk = 0;
+		for(int j = 0; j < state->sunkCount && !sunk; j++) {
+			if(!used[j] && state->sunkShips[j] == partCount) {
+				used[j] = 1;
+				sunk = 1;
+			}
+		}
+		if(!sunk && (shortest == 0 || partCount < shortest)) shortest = partCount;
+	}
+	return shortest > 0 ? shortest : 1;
+}
+
+// Counts the sunk cells connected to cell, which are the ship that has just sunk unless it touches another sunk ship.
+static int countSunkShip(const unsigned char* cells, int rows, int cols, int cell) {
+	unsigned char seen[256] = { 0 };
+	int stack[256];
+	int size = 0, count = 0;
+	stack[size++] = cell;
+	seen[cell] = 1;
+	while(size > 0) {
+		int current = stack[--size];
+		count++;
+		int cx = current % cols, cy = current / cols;
+		const int neighbours[4] = { cx > 0 ? current - 1 : -1, cx < cols - 1 ? current + 1 : -1, cy > 0 ? current - cols : -1,
+			cy < rows - 1 ? current + cols : -1 };
+		for(int i = 0; i < 4; i++) {
+			if(neighbours[i] == -1 || seen[neighbours[i]] || cells[neighbours[i]] != STRATEGY_CELL_SUNK) continue;
+			seen[neighbours[i]] = 1;
+			stack[size++] = neighbours[i];
+		}
+	}
+	return count;
+}
+
+static void chooseExampleAttack(void* data, const unsigned char* cells, int* x, int* y) {
+	ExampleState* state = data;
+	int rows = state->game.rows, cols = state->game.cols;
+	if(state->pendingSunk != -1 && rows * cols <= 256 && state->sunkCount < 64) {
+		state->sunkShips[state->sunkCount++] = (unsigned char) countSunkShip(cells, rows, cols, state->pendingSunk);
+	}
+	state->pendingSunk = -1;
+
+	// Target: an unknown neighbour of a hit that isn't part of a sunk ship yet
+	const int directions[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+	for(int cell = 0; cell < rows * cols; cell++) {
+		if(cells[cell] != STRATEGY_CELL_HIT) continue;
+		for(int d = 0; d < 4; d++) {
+			int nx = cell % cols + directions[d][0], ny = cell / cols + directions[d][1];
+			if(nx < 0 || nx >= cols || ny < 0 || ny >= rows || cells[ny * cols + nx] != STRATEGY_CELL_UNKNOWN) continue;
+			*x = nx;
+			*y = ny;
+			return;
+		}
+	}
+
+	// Hunt: a random unknown cell on the diagonals every ship left must cross, or any unknown cell
+	int spacing = getShortestShipLeft(state);
+	int candidates = 0, fallback = -1;
+	for(int cell = 0; cell < rows * cols; cell++) {
+		if(cells[cell] != STRATEGY_CELL_UNKNOWN) continue;
+		fallback = cell;
+		if((cell % cols + cell / cols) % spacing == 0) candidates++;
+	}
+	int chosen = fallback;
+	if(candidates > 0) {
+		int skip = (int) (nextExampleRandom(state) % candidates);
+		for(int cell = 0; cell < rows * cols; cell++) {
+			if(cells[cell] != STRATEGY_CELL_UNKNOWN || (cell % cols + cell / cols) % spacing != 0) continue;
+			if(skip-- == 0) {
+				chosen = cell;
+				break;
+			}
+		}
+	}
+	*x = chosen % cols;
+	*y = chosen / cols;
+}
+
+// Hits and misses are already in the cells passed to chooseAttack; only sunk ships need remembering, since the cells
+// don't say which ship sank.
+static void observeExample(void* data, int x, int y, int result) {
+	ExampleState* state = data;
+	if(result == STRATEGY_RESULT_SUNK) state->pendingSunk = y * state->game.cols + x;
+}
+
+static const BattleshipStrategy exampleStrategy = {
+	.abiVersion = BATTLESHIP_STRATEGY_ABI_VERSION,
+	.name = "example",
+	.create = createExample,
+	.destroy = destroyExample,
+	.placeFleet = placeExampleFleet,
+	.chooseAttack = chooseExampleAttack,
+	.observe = observeExample
+};
+
+const BattleshipStrategy* getBattleshipStrategy(void) {
+	return &exampleStrategy;
+}
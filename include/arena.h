@@ -0,0 +1,24 @@
+#pragma once
+#include <stddef.h>
+#include "memstats.h"
+
+// Every allocation is rounded up to this, so that any type can be stored in an arena
+#define ARENA_ALIGNMENT 16
+// Capacity of the arena holding the state of a match: ships, hitmaps and request buffers
+#define MATCH_ARENA_SIZE (256 * 1024)
+
+// A bump allocator: allocating moves a cursor forward, and everything is released at once by resetting it.
+// Arenas aren't thread-safe; only one thread may allocate from an arena at a time.
+typedef struct {
+	char* base;
+	size_t capacity;
+	size_t used;
+	size_t highWater;
+	size_t taggedBytes[MEM_TAG_COUNT]; // What each subsystem has allocated since the last reset
+	size_t taggedCount[MEM_TAG_COUNT];
+} Arena;
+
+void initArena(Arena* arena, size_t capacity);
+void* arenaAlloc(Arena* arena, size_t size, enum MemTagEnum tag);
+void resetArena(Arena* arena);
+void freeArena(Arena* arena);
@@ -0,0 +1,29 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+// Maximum amount of quads collected before a batch is submitted anyway
+#define SPRITE_BATCH_SIZE 512
+
+typedef struct {
+	unsigned long drawCalls;
+	unsigned long quads;
+} FrameStats;
+
+typedef struct {
+	SDL_Texture* texture;
+	int textureWidth;
+	int textureHeight;
+	int count;
+	SDL_Vertex vertices[4 * SPRITE_BATCH_SIZE];
+	int indices[6 * SPRITE_BATCH_SIZE];
+	unsigned long frame;
+	FrameStats currentFrame;
+	FrameStats lastFrame;
+} SpriteBatch;
+
+extern SpriteBatch spriteBatch;
+
+void batchQuad(SDL_Texture* texture, const SDL_Rect* srcrect, const SDL_FRect* dstrect, double angle, SDL_Color color);
+void flushBatch();
+void presentFrame();
+void printFrameStats();
@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+
+// A bitboard holds one bit per cell; cell (x, y) is bit y * BITBOARD_STRIDE + x, so grids up to 16x16 fit in 4 words
+#define BITBOARD_STRIDE 16
+#define BITBOARD_MAX_SIZE 16
+#define BITBOARD_WORDS (BITBOARD_STRIDE * BITBOARD_MAX_SIZE / 64)
+
+typedef struct {
+	uint64_t words[BITBOARD_WORDS];
+} Bitboard;
+
+static inline int getBitIndex(int x, int y) {
+	return y * BITBOARD_STRIDE + x;
+}
+
+static inline void clearBitboard(Bitboard* board) {
+	for(int i = 0; i < BITBOARD_WORDS; i++) board->words[i] = 0;
+}
+
+static inline void setBit(Bitboard* board, int x, int y) {
+	int bit = getBitIndex(x, y);
+	board->words[bit / 64] |= (uint64_t) 1 << (bit % 64);
+}
+
+static inline void clearBit(Bitboard* board, int x, int y) {
+	int bit = getBitIndex(x, y);
+	board->words[bit / 64] &= ~((uint64_t) 1 << (bit % 64));
+}
+
+static inline unsigned char testBit(const Bitboard* board, int x, int y) {
+	int bit = getBitIndex(x, y);
+	return (board->words[bit / 64] >> (bit % 64)) & 1;
+}
+
+static inline unsigned char bitboardsIntersect(const Bitboard* a, const Bitboard* b) {
+	uint64_t any = 0;
+	for(int i = 0; i < BITBOARD_WORDS; i++) any |= a->words[i] & b->words[i];
+	return any != 0;
+}
+
+// Returns 1 if every bit of a is also set in b
+static inline unsigned char bitboardIsSubset(const Bitboard* a, const Bitboard* b) {
+	uint64_t outside = 0;
+	for(int i = 0; i < BITBOARD_WORDS; i++) outside |= a->words[i] & ~b->words[i];
+	return outside == 0;
+}
+
+static inline void orBitboard(Bitboard* dst, const Bitboard* src) {
+	for(int i = 0; i < BITBOARD_WORDS; i++) dst->words[i] |= src->words[i];
+}
+
+static inline void andBitboard(Bitboard* dst, const Bitboard* src) {
+	for(int i = 0; i < BITBOARD_WORDS; i++) dst->words[i] &= src->words[i];
+}
+
+static inline void andNotBitboard(Bitboard* dst, const Bitboard* src) {
+	for(int i = 0; i < BITBOARD_WORDS; i++) dst->words[i] &= ~src->words[i];
+}
+
+static inline unsigned char isBitboardEmpty(const Bitboard* board) {
+	uint64_t any = 0;
+	for(int i = 0; i < BITBOARD_WORDS; i++) any |= board->words[i];
+	return any == 0;
+}
+
+void makeBoardMask(Bitboard* board, int rows, int cols);
+void shiftBitboard(Bitboard* dst, const Bitboard* src, int x, int y);
+int countBits(const Bitboard* board);
+int nextBit(const Bitboard* board, int from);
+int nthBit(const Bitboard* board, int n);
+void floodFillBitboard(Bitboard* dst, const Bitboard* src, int x, int y);
+unsigned char findNearestBit(const Bitboard* board, int x, int y, int* nearestX, int* nearestY);
@@ -0,0 +1,5 @@
+#pragma once
+#include "ship.h"
+
+int loadFleetFile(const char* path, Ship* definitions[MAX_SHIPS]);
+void addShipDefinition(Ship* definitions[MAX_SHIPS], int index, const char* name, char rows[SHIP_MATRIX_SIZE][SHIP_MATRIX_SIZE + 1], int height);
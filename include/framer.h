@@ -0,0 +1,29 @@
+#pragma once
+#include <stddef.h>
+
+#define FRAMER_CAPACITY 65536
+
+// A read-only slice of a buffer; it isn't NUL-terminated.
+typedef struct {
+    const char* data;
+    size_t length;
+} MessageView;
+
+// Splits a byte stream into "\r\n\r\n"-terminated messages or, once binary is set,
+// into frames prefixed with their 2-byte big-endian length.
+typedef struct {
+    char buffer[FRAMER_CAPACITY];
+    unsigned char binary;
+    size_t start;   // First byte that hasn't been handed out yet
+    size_t end;     // One past the last received byte
+    size_t scanned; // Bytes after start already searched for a terminator
+} MessageFramer;
+
+void initFramer(MessageFramer* framer);
+char* getFramerWriteSpace(MessageFramer* framer, size_t* available);
+void commitFramerWrite(MessageFramer* framer, size_t length);
+unsigned char nextMessage(MessageFramer* framer, MessageView* message);
+unsigned char nextLine(MessageView* message, MessageView* line);
+unsigned char nextToken(MessageView* line, MessageView* token);
+unsigned char viewEquals(MessageView view, const char* str);
+unsigned char parseViewInt(MessageView view, int* value);
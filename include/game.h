@@ -1,17 +1,35 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include "placement.h"
+
+// Frame rate cap, only used when the renderer can't wait for vsync
+#define MAX_FPS 60
+// Threads sampling fleets for the optimized auto-place
+#define MAX_PLACEMENT_THREADS 16
+
 
 void gameLoop();
 Uint32 getTimeLeft(Uint32 nextTime);
 char handleEvent(SDL_Event ev);
 void setStatusBar(const char* text);
+void drawBoard();
+void composeBoard();
+void renderBoardLayer(int width, int height);
+void invalidateBoardLayer();
 void drawGrid(int xOffset, int yOffset);
 void drawGridCoords(int xOffset, int yOffset, int labelSet);
 void drawHitmap(Hitmap* hitmap, int xOffset, int yOffset);
+const DensityMap* updateTargetDensity();
+void drawTargetHint(const DensityMap* density, int xOffset, int yOffset);
 void handleAttack(int xOffset, int yOffset, int gridWidth, int gridHeight, char state);
 void renderShip(Ship* ship, Uint8 alphaMod, int x, int y, int xOffset, int yOffset);
 void convertMouseCoordsToGrid(int mouseX, int mouseY, int xOffset, int yOffset, int* gridX, int* gridY);
+void nextShip();
+void previousShip();
 unsigned char handleShipPlacement(int xOffset, int yOffset, int gridWidth, int gridHeight, char state);
+unsigned char isFleetSearchRunning();
+unsigned char collectFleetSearch(FleetLayout* layout);
+unsigned char autoPlaceFleet(enum AutoPlaceEnum mode);
+void drawIllegalPlacementCells(const PlacementIndex* index, int xOffset, int yOffset);
 void drawShipPlacementOverlay(Ship* ship, int xOffset, int yOffset, int gridWidth, int gridHeight);
 void drawPlacedShips(int xOffset, int yOffset);
-Ship* checkCollisionWithPlacedShips(Ship* ship);
\ No newline at end of file
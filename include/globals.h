@@ -1,53 +1,74 @@
 #pragma once
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_net.h>
 #include <SDL2/SDL_ttf.h>
 #include "ship.h"
+#include "hitmap.h"
+#include "arena.h"
+#include "targeting.h"
+#include "strategyhost.h"
 
-#define PROTOCOL_VERSION "1.0"
-#define NUMBER_OF_SHIPS 5
 
 extern char* nickname;
 extern SDL_Window* window;
 extern SDL_Renderer* renderer;
-extern SDL_Texture* gridSquareA;
-extern SDL_Texture* gridSquareB;
-extern SDL_Texture* mouseOverlay;
-extern SDL_Texture* shipFront;
-extern SDL_Texture* shipMiddle;
-extern SDL_Texture* shipBack;
-extern SDL_Texture* hitOverlay;
-extern SDL_Texture* missedOverlay;
-extern Ship* destroyer;
-extern Ship* submarine;
-extern Ship* cruiser;
-extern Ship* battleship;
-extern Ship* carrier;
-extern Ship* globalShips[NUMBER_OF_SHIPS];
-extern Ship* ships[NUMBER_OF_SHIPS];
+enum SpriteEnum {
+    GRID_SQUARE_A_SPRITE,
+    GRID_SQUARE_B_SPRITE,
+    MOUSE_OVERLAY_SPRITE,
+    SHIP_FRONT_SPRITE,
+    SHIP_MIDDLE_SPRITE,
+    SHIP_BACK_SPRITE,
+    HIT_OVERLAY_SPRITE,
+    MISSED_OVERLAY_SPRITE,
+    NUMBER_OF_SPRITES
+};
+extern SDL_Texture* spriteAtlas;
+extern SDL_Rect sprites[NUMBER_OF_SPRITES];
+extern char* fleetPath;
+extern int numberOfShips;
+extern Ship* shipDefinitions[MAX_SHIPS];
+extern Ship* globalShips[MAX_SHIPS];
+extern Arena matchArena;
+extern Fleet fleet;
+extern PlacementIndex placementIndex;
 extern TTF_Font* mainFont;
-extern SDL_Texture** gridColLabels;
-extern SDL_Texture** gridRowLabels;
+extern SDL_Texture* boardLayer;
+extern int boardLayerSquareWidth;
+extern int boardLayerSquareHeight;
+extern int boardLayerCols;
+extern int boardLayerRows;
 extern int screenWidth;
 extern int screenHeight;
 extern int squareWidth;
 extern int squareHeight;
 extern int cols;
 extern int rows;
+extern Bitboard gridMask;
 extern unsigned char currentShip;
 extern unsigned char currentScene;
 extern SDL_Thread* networkThread;
 extern char* serverAddress;
 extern long int serverPort;
-extern TCPsocket serverSocket;
-extern SDLNet_SocketSet socketSet;
 extern char opponentNickname[64];
-typedef struct {
-    char** map;
-    SDL_mutex* mutex;
-} Hitmap;
 extern Hitmap* ownHitmap;
 extern Hitmap* opponentHitmap;
+extern DensityMap targetDensity;
+extern unsigned int targetDensityVersion;
+extern unsigned char showTargetHint;
+extern unsigned char autoPlay;
+enum AutoPlaceEnum {
+    AUTO_PLACE_NONE,
+    AUTO_PLACE_RANDOM,
+    AUTO_PLACE_OPTIMIZED,
+    AUTO_PLACE_STRATEGY
+};
+extern enum AutoPlaceEnum autoPlaceRequest;
+extern unsigned char autoPlaceFailed;
+extern char* strategyPath;
+extern StrategyPlugin strategyPlugin;
+extern StrategyShip strategyShips[MAX_SHIPS];
+extern StrategyGame strategyGame;
+extern void* strategyState;
 
 // Game state flag data
 #define STOP_RUNNING 0x1
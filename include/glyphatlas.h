@@ -0,0 +1,25 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+// Printable ASCII range that's pre-rasterized into the atlas
+#define GLYPH_ATLAS_FIRST 32
+#define GLYPH_ATLAS_LAST 126
+#define GLYPH_ATLAS_COUNT (GLYPH_ATLAS_LAST - GLYPH_ATLAS_FIRST + 1)
+#define GLYPH_ATLAS_WIDTH 512
+
+typedef struct {
+	SDL_Texture* texture;
+	int width;
+	int height;
+	int lineHeight;
+	SDL_Rect glyphs[GLYPH_ATLAS_COUNT]; // Cell of each glyph in the atlas; its width is the glyph's advance
+} GlyphAtlas;
+
+extern GlyphAtlas glyphAtlas;
+
+void loadGlyphAtlas(TTF_Font* font);
+unsigned char canDrawText(const char* text);
+void measureText(const char* text, int* width, int* height);
+void drawText(const char* text, SDL_Rect* dstrect, SDL_Color color);
+void destroyGlyphAtlas();
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdatomic.h>
+#include "bitboard.h"
+#include "arena.h"
+
+typedef struct {
+	Bitboard misses;
+	Bitboard hits;
+	Bitboard sunk; // Hit cells belonging to ships that have been sunk
+} HitmapBuffer;
+
+// A hitmap is written by the network thread only and read by the render thread without locks.
+// The writer fills the back buffer and publishes it by adding 2 to version; the published buffer is (version / 2) % 2.
+typedef struct {
+	HitmapBuffer buffers[2];
+	atomic_uint version;
+
+	// Render thread only: the overlay cells of the last snapshot that has been drawn
+	unsigned int drawnVersion;
+	int drawnCount;
+	unsigned short drawnCells[BITBOARD_STRIDE * BITBOARD_MAX_SIZE];
+} Hitmap;
+
+// Marks a drawn cell as a hit rather than a miss, and a hit as part of a sunk ship
+#define HITMAP_DRAWN_HIT 0x8000
+#define HITMAP_DRAWN_SUNK 0x4000
+
+Hitmap* initHitmap(Arena* arena);
+void resetHitmap(Hitmap* hitmap);
+void setHitmapField(Hitmap* hitmap, int x, int y, char value);
+void markHitmapSunk(Hitmap* hitmap, const Bitboard* cells);
+char getHitmapField(Hitmap* hitmap, int x, int y);
+unsigned int getHitmapSnapshot(Hitmap* hitmap, HitmapBuffer* snapshot);
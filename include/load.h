@@ -3,21 +3,20 @@
 #include <SDL2/SDL_ttf.h>
 #include "globals.h"
 #include "ship.h"
+#include "memstats.h"
+
+#define SPRITE_ATLAS_MAX_WIDTH 512
 
-// strtok_r is widely used in the program but not defined in mingw
-#if defined(__MINGW32__) || defined(__MINGW64__)
-char* strtok_r(char *str, const char *delim, char **nextp);
-#endif
 void init();
-SDL_Texture* loadTexture(const char* path, int* width, int* height);
+void loadSpriteAtlas();
+void renderSprite(enum SpriteEnum sprite, SDL_Rect* dstrect, double angle);
+void renderSpriteMod(enum SpriteEnum sprite, SDL_Rect* dstrect, double angle, SDL_Color color);
 void renderCopy(SDL_Texture* texture, SDL_Rect* dstrect, double angle);
-void setTextureAlphaMod(SDL_Texture* texture, Uint8 alphaMod);
+void renderCopyMod(SDL_Texture* texture, SDL_Rect* dstrect, double angle, SDL_Color color);
 TTF_Font* loadFont(const char* path, int ptsize);
+void trackTexture(enum MemTagEnum tag, SDL_Texture* texture);
+void destroyTrackedTexture(enum MemTagEnum tag, SDL_Texture* texture);
 SDL_Texture* getFontTexture(TTF_Font* font, const char* text, SDL_Color fgColor);
-void loadGridCoordLabels();
-char** allocateAndZeroMatrix(int sizeY, int sizeX);
-void copyMatrix(char** dst, char** src, int sizeY, int sizeX);
-void freeMatrix(char** matrix, int sizeY, int sizeX);
-void loadShips();
-Hitmap* initHitmap();
+void startMatch();
+void endMatch();
 void destroy();
@@ -0,0 +1,21 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+
+// Subsystems that memory is accounted to. Textures count as their pixel data, 4 bytes per pixel.
+enum MemTagEnum {
+	MEM_SHIPS,
+	MEM_HITMAPS,
+	MEM_NETWORK,
+	MEM_TEXT,
+	MEM_ASSETS,
+	MEM_TAG_COUNT
+};
+
+void recordAllocation(enum MemTagEnum tag, size_t size);
+void recordRelease(enum MemTagEnum tag, size_t size, size_t count);
+void* trackedMalloc(enum MemTagEnum tag, size_t size);
+void* trackedRealloc(enum MemTagEnum tag, void* memory, size_t oldSize, size_t size);
+void trackedFree(enum MemTagEnum tag, void* memory, size_t size);
+size_t getAllocationCount();
+void printMemoryReport(FILE* out);
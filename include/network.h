@@ -1,8 +1,11 @@
 #pragma once
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_net.h>
 #include "globals.h"
 #include "ship.h"
+#include "framer.h"
+#include "transport.h"
+#include "protocol.h"
+#include "rules.h"
 
 enum NetworkStateEnum {
     CONNECTING,
@@ -30,26 +33,35 @@ typedef struct {
     char clientInfo;
     int x;
     int y;
+    ConnectionTimings connection;
 } NetworkState;
 
 extern NetworkState networkState;
+extern Uint32 networkEventType;
+extern unsigned char binaryProtocol;
 
 void initNetwork();
 int networkMain(void* data);
 void lockMutex(SDL_mutex* m);
+void notifyNetworkChange();
+void setConnectionTimings(const ConnectionTimings* timings);
+void getConnectionTimings(ConnectionTimings* timings);
 void setNetworkState(enum NetworkStateEnum s);
 enum NetworkStateEnum getNetworkState();
-void waitForServer(char* response, int maxResponseLength);
+void waitForServer(MessageView* message);
+void waitServerMessage(ServerMessage* message);
+void failOnMessage(const ServerMessage* message, const char* context);
 void waitForClientSignal();
+void signalClientInfo();
 void zeroClientSignal();
-void runRequest(const char* message, char* response, int maxResponseLength);
+void runRequest(ServerMessage* response);
 char runHelloRequest();
 void waitMatched();
-void handleMatched(char** lineSavePtr);
+void handleMatched(const ServerMessage* message);
 char runReadyRequest();
 char waitOpponentShipsPlaced();
-void setHitmapField(Hitmap* hitmap, int x, int y, char value);
-char getHitmapField(Hitmap* hitmap, int x, int y);
+void recordOwnAttack(int x, int y, enum AttackOutcomeEnum outcome);
+void recordOpponentAttack(int x, int y, enum AttackOutcomeEnum reported);
 char handleOwnTurn();
-void getOpponentActionCoords(char* secondLine, int* x, int* y);
+void getOpponentActionCoords(const ServerMessage* message, int* x, int* y);
 char handleOpponentTurn();
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include <stddef.h>
+#include "arena.h"
+
+// A growable byte buffer for outgoing messages. It is meant to be reused: resetting keeps the allocation, so once it
+// has grown to the biggest message sent, building a message doesn't allocate.
+// Buffers with an arena grow by taking a new block from it, and their memory is released with the arena.
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    Arena* arena;
+} OutputBuffer;
+
+void initOutputBuffer(OutputBuffer* buffer, Arena* arena);
+void freeOutputBuffer(OutputBuffer* buffer);
+void resetOutputBuffer(OutputBuffer* buffer);
+void reserveOutputBuffer(OutputBuffer* buffer, size_t size);
+char* claimOutputBuffer(OutputBuffer* buffer, size_t size);
+void writeBytes(OutputBuffer* buffer, const void* data, size_t size);
+void writeString(OutputBuffer* buffer, const char* string);
+void writeChar(OutputBuffer* buffer, char c);
+void writeInt(OutputBuffer* buffer, int value);
+size_t getIntLength(int value);
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include "bitboard.h"
+#include "ship.h"
+#include "targeting.h"
+
+// Candidate fleets sampled per thread by the optimized auto-place
+#define OPTIMIZED_PLACEMENT_CANDIDATES 8192
+
+// Every placement of each ship inside an empty grid, computed once, so that sampling a fleet is a few random picks.
+typedef struct {
+	int count;
+	const Ship* ships[MAX_SHIPS];
+	Bitboard anchors[MAX_SHIPS][NUMBER_OF_ORIENTATIONS];
+	int anchorCounts[MAX_SHIPS][NUMBER_OF_ORIENTATIONS];
+	int placementCounts[MAX_SHIPS];
+	DensityMap heat;  // How often hunting bots expect a ship on each cell of the empty grid
+	int touchPenalty; // Score added for every side a ship shares with another ship
+} FleetPlacer;
+
+// Where every ship of a fleet goes, without touching the ships themselves.
+typedef struct {
+	char rotations[MAX_SHIPS];
+	int x[MAX_SHIPS];
+	int y[MAX_SHIPS];
+	Bitboard masks[MAX_SHIPS];
+	Bitboard occupied;
+} FleetLayout;
+
+unsigned char initFleetPlacer(FleetPlacer* placer, Ship* const* ships, int count, const Bitboard* grid);
+unsigned char sampleRandomFleet(const FleetPlacer* placer, FleetLayout* layout, uint64_t* rng);
+int scoreFleetLayout(const FleetPlacer* placer, const FleetLayout* layout);
+unsigned char sampleBestFleet(const FleetPlacer* placer, int candidates, uint64_t* rng, FleetLayout* best, int* bestScore);
+void applyFleetLayout(const FleetLayout* layout, Ship** ships, int count, Fleet* fleet);
@@ -0,0 +1,63 @@
+#pragma once
+#include <stddef.h>
+#include "framer.h"
+#include "ship.h"
+#include "outbuffer.h"
+
+#define PROTOCOL_VERSION "1.0"
+
+// Offered in the hello request next to PROTOCOL_VERSION; servers that support it answer with "version 2.0"
+#define BINARY_PROTOCOL_VERSION "2.0"
+
+// Binary frames are a 2-byte big-endian body length followed by the body: a type byte and fixed-size fields
+#define BINARY_FRAME_HEADER_SIZE 2
+#define BINARY_ATTACK_SIZE (BINARY_FRAME_HEADER_SIZE + 3)
+
+enum BinaryTypeEnum {
+    BINARY_READY = 0x01,      // u8 rows, u8 cols, u8 ship count, then per ship u8 index and a rows * cols bit occupancy mask
+    BINARY_ATTACK = 0x02,     // u8 x, u8 y
+    BINARY_WAIT_MATCH = 0x10,
+    BINARY_MATCHED = 0x11,    // u8 name length, name
+    BINARY_WAIT_SHIPS = 0x12,
+    BINARY_YOUR_TURN = 0x13,
+    BINARY_WAIT_TURN = 0x14,
+    BINARY_NO_HIT = 0x20,     // u8 x, u8 y
+    BINARY_HIT = 0x21,        // u8 x, u8 y
+    BINARY_HIT_SUNK = 0x22,   // u8 x, u8 y
+    BINARY_YOU_WIN = 0x23,
+    BINARY_YOU_LOSE = 0x24
+};
+
+enum ServerMessageEnum {
+    SERVER_UNKNOWN,
+    SERVER_WAIT_MATCH,
+    SERVER_MATCHED,
+    SERVER_WAIT_SHIPS,
+    SERVER_YOUR_TURN,
+    SERVER_WAIT_TURN,
+    SERVER_NO_HIT,
+    SERVER_HIT,
+    SERVER_HIT_SUNK,
+    SERVER_YOU_WIN,
+    SERVER_YOU_LOSE
+};
+
+// A decoded server message; the views point into the framer's buffer.
+typedef struct {
+    enum ServerMessageEnum type;
+    MessageView header; // Text header, or the whole frame for binary messages
+    unsigned char hasCoords;
+    int x;
+    int y;
+    MessageView name;
+    MessageView version;
+} ServerMessage;
+
+void decodeTextMessage(MessageView message, ServerMessage* out);
+void decodeBinaryMessage(MessageView message, ServerMessage* out);
+void encodeTextHello(OutputBuffer* out, const char* nickname, int rows, int cols);
+void encodeTextReady(OutputBuffer* out, Ship** ships, int amount);
+void encodeTextAttack(OutputBuffer* out, int x, int y);
+size_t getBinaryReadySize(int amount, int rows, int cols);
+void encodeBinaryReady(OutputBuffer* out, Ship** ships, int amount, int rows, int cols);
+void encodeBinaryAttack(OutputBuffer* out, int x, int y);
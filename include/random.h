@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+// SplitMix64: a fast generator whose every seed gives an independent, reproducible stream. Not for anything secret.
+static inline uint64_t nextRandom(uint64_t* state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// Returns a number in [0, bound); the modulo bias is negligible for the small bounds used here.
+static inline int randomBelow(uint64_t* state, int bound) {
+	return (int) (nextRandom(state) % (uint64_t) bound);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "bitboard.h"
+#include "hitmap.h"
+#include "ship.h"
+
+// The game rules as the server applies them, so that the client can refuse invalid actions without a round trip.
+
+enum RuleResultEnum {
+	RULE_OK,
+	RULE_OUT_OF_GRID,
+	RULE_ALREADY_ATTACKED,
+	RULE_FLEET_INCOMPLETE,
+	RULE_SHIP_OUT_OF_GRID,
+	RULE_SHIPS_OVERLAP
+};
+
+enum AttackOutcomeEnum {
+	ATTACK_MISS,
+	ATTACK_HIT,
+	ATTACK_SUNK,
+	ATTACK_FLEET_SUNK
+};
+
+enum RuleResultEnum validateAttack(const HitmapBuffer* hitmap, const Bitboard* grid, int x, int y);
+enum RuleResultEnum validateFleet(const Fleet* fleet, int numberOfShips, const Bitboard* grid);
+enum AttackOutcomeEnum resolveAttack(const Fleet* fleet, const Bitboard* hits, int x, int y, Bitboard* sunkShip);
+void findSunkShip(const HitmapBuffer* hitmap, int x, int y, Bitboard* sunkShip);
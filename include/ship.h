@@ -1,4 +1,32 @@
 #pragma once
+#include <stddef.h>
+#include "bitboard.h"
+#include "outbuffer.h"
+
+// Ship matrices are stored inline, row by row
+#define SHIP_MATRIX_SIZE 5
+// Capacity of a Fleet
+#define MAX_SHIPS 16
+#define NUMBER_OF_ORIENTATIONS 4
+
+typedef struct {
+	signed char x;
+	signed char y;
+	char type; // 'F', 'M' or 'B'
+} ShipPart;
+
+// A ship turned clockwise by angle degrees, computed once when the ship is defined.
+typedef struct {
+	char matrix[SHIP_MATRIX_SIZE][SHIP_MATRIX_SIZE];
+	Bitboard shape; // Cells of matrix, moved so that the top-left corner of their bounding box is bit 0
+	int top;
+	int left;
+	int height;
+	int width;
+	int partCount;
+	ShipPart parts[SHIP_MATRIX_SIZE * SHIP_MATRIX_SIZE];
+	double angle;
+} ShipOrientation;
 
 typedef struct {
 	char name[20];
@@ -8,17 +36,50 @@ typedef struct {
 	int y;
 	int sizeY;
 	int sizeX;
-	char** matrix;
+	char matrix[SHIP_MATRIX_SIZE][SHIP_MATRIX_SIZE]; // Definition of the ship, not rotated
+	ShipOrientation orientations[NUMBER_OF_ORIENTATIONS];
 } Ship;
 
+static inline const ShipOrientation* getShipOrientation(const Ship* ship) {
+	return &ship->orientations[(int) ship->rotation];
+}
+
+// Placed ships in placement order. The masks are kept in their own array, so a collision check scans contiguous memory.
+typedef struct {
+	int count;
+	Ship* ships[MAX_SHIPS];
+	Bitboard masks[MAX_SHIPS];
+	Bitboard occupied;
+	unsigned int version; // Changes whenever a ship is added or removed
+} Fleet;
+
+// Where a ship can legally go in its current orientation, given the placed fleet. An anchor is the grid cell of the
+// top-left corner of the shape's bounding box; centers are the cells the center of the ship's matrix can be on.
+typedef struct {
+	const Ship* ship;
+	char rotation;
+	unsigned int fleetVersion;
+	unsigned char valid;
+	Bitboard anchors;
+	Bitboard centers;
+} PlacementIndex;
+
 Ship* makeShip(const char name[20], unsigned char index, int sizeY, int sizeX);
 Ship* copyShip(Ship* src);
 void freeShip(Ship* ship);
-void nextShip();
-void previousShip();
+void buildShipOrientations(Ship* ship);
+unsigned char getShipMask(Ship* ship, Bitboard* mask);
+unsigned char checkShipFitsGrid(Ship* ship, const Bitboard* grid);
+void clearFleet(Fleet* fleet);
+void addShipToFleet(Fleet* fleet, Ship* ship);
+Ship* removeLastShipFromFleet(Fleet* fleet);
+Ship* findFleetCollision(const Fleet* fleet, Ship* ship);
+void updatePlacementIndex(PlacementIndex* index, const Fleet* fleet, const Ship* ship, const Bitboard* grid);
+void invalidatePlacementIndex(PlacementIndex* index);
 void getShipEdges(Ship* ship, int* top, int* bottom, int* left, int* right);
-void changeShipRotation(Ship* matrix, int size);
+void changeShipRotation(Ship* ship);
 unsigned char checkShipCollision(Ship* ship1, Ship* ship2);
-void dynamicStrcat(char** str, char* str2);
-char* stringifyShip(Ship* ship);
-char* stringifyShips(Ship** ships, int amount);
\ No newline at end of file
+size_t getShipTextSize(Ship* ship);
+void stringifyShip(OutputBuffer* out, Ship* ship);
+size_t getShipsTextSize(Ship** ships, int amount);
+void stringifyShips(OutputBuffer* out, Ship** ships, int amount);
@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+
+// The interface between the game and placement/targeting strategies loaded from shared objects. It only uses plain C
+// types, so that plugins can be built against this header alone. Changes that break plugins bump
+// BATTLESHIP_STRATEGY_ABI_VERSION; hosts refuse plugins built for another version.
+//
+// A plugin exports getBattleshipStrategy, returning a BattleshipStrategy that lives as long as the plugin is loaded.
+// The host creates one state per match and calls the functions of a state from one thread at a time.
+
+#define BATTLESHIP_STRATEGY_ABI_VERSION 1
+#define BATTLESHIP_STRATEGY_SYMBOL "getBattleshipStrategy"
+#define STRATEGY_SHIP_SIZE 5
+
+// A ship as defined in the fleet file: its matrix holds 'F', 'M' or 'B' for every part and 0 for empty cells
+typedef struct {
+	const char* name;
+	int partCount;
+	char matrix[STRATEGY_SHIP_SIZE][STRATEGY_SHIP_SIZE];
+} StrategyShip;
+
+typedef struct {
+	int rows;
+	int cols;
+	int shipCount;
+	const StrategyShip* ships;
+} StrategyGame;
+
+// What is known about a cell of the opponent's field; cells are passed row by row, cells[y * cols + x]
+enum StrategyCellEnum {
+	STRATEGY_CELL_UNKNOWN,
+	STRATEGY_CELL_MISS,
+	STRATEGY_CELL_HIT,
+	STRATEGY_CELL_SUNK
+};
+
+enum StrategyResultEnum {
+	STRATEGY_RESULT_MISS,
+	STRATEGY_RESULT_HIT,
+	STRATEGY_RESULT_SUNK
+};
+
+// Where a ship goes: its matrix turned clockwise rotation times, with the matrix's top-left corner on cell (x, y).
+// The corner can be outside the field as long as every part is inside.
+typedef struct {
+	int rotation;
+	int x;
+	int y;
+} StrategyPlacement;
+
+typedef struct {
+	unsigned int abiVersion; // BATTLESHIP_STRATEGY_ABI_VERSION
+	const char* name;
+	void* (*create)(const StrategyGame* game, uint64_t seed);
+	void (*destroy)(void* state);
+	// Fills one placement per ship of the game, in order. Returning 0 lets the host place the fleet at random.
+	int (*placeFleet)(void* state, StrategyPlacement* placements);
+	// Picks a cell that hasn't been attacked yet.
+	void (*chooseAttack)(void* state, const unsigned char* cells, int* x, int* y);
+	// Called with the result of every attack of the strategy.
+	void (*observe)(void* state, int x, int y, int result);
+} BattleshipStrategy;
+
+typedef const BattleshipStrategy* (*GetBattleshipStrategyFunction)(void);
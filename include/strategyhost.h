@@ -0,0 +1,18 @@
+#pragma once
+#include "strategy.h"
+#include "hitmap.h"
+#include "placement.h"
+#include "ship.h"
+
+// A strategy plugin loaded by a host: the client, the simulator or any other program linking the core library
+typedef struct {
+	void* handle;
+	const BattleshipStrategy* strategy;
+} StrategyPlugin;
+
+void loadStrategyPlugin(StrategyPlugin* plugin, const char* path);
+void unloadStrategyPlugin(StrategyPlugin* plugin);
+void describeStrategyGame(StrategyGame* game, StrategyShip ships[MAX_SHIPS], Ship* const* definitions, int count, int rows, int cols);
+void getStrategyCells(unsigned char* cells, const HitmapBuffer* view, int rows, int cols);
+unsigned char getStrategyFleetLayout(const StrategyPlacement* placements, Ship* const* definitions, int count, const Bitboard* grid,
+	FleetLayout* layout);
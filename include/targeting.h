@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include "bitboard.h"
+#include "hitmap.h"
+#include "ship.h"
+
+#define DENSITY_CELLS (BITBOARD_STRIDE * BITBOARD_MAX_SIZE)
+
+// How many of the opponent's possible fleet placements cover each cell, laid out like a bitboard: a row of the grid is
+// BITBOARD_STRIDE consecutive counters, so a row of a placement mask is added with one SIMD operation per 8 cells.
+typedef struct {
+	_Alignas(16) uint16_t cells[DENSITY_CELLS];
+	unsigned char targeting; // 1 if only placements through the unsunk hits were counted
+	int bestX;
+	int bestY;
+	uint16_t bestDensity;
+} DensityMap;
+
+int getRemainingShips(const HitmapBuffer* hitmap, Ship* const* ships, int count, const Ship** remaining);
+void computeDensityMap(DensityMap* map, const HitmapBuffer* hitmap, const Bitboard* grid, const Ship* const* ships, int count);
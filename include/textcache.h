@@ -0,0 +1,29 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#define TEXT_CACHE_SIZE 32
+
+typedef struct {
+	TTF_Font* font;
+	SDL_Color color;
+	Uint32 hash;
+	char* text;
+	SDL_Texture* texture;
+	int width;
+	int height;
+	Uint32 lastUsed;
+} TextCacheEntry;
+
+typedef struct {
+	TextCacheEntry entries[TEXT_CACHE_SIZE];
+	Uint32 clock;
+	unsigned long hits;
+	unsigned long misses;
+} TextCache;
+
+extern TextCache textCache;
+
+SDL_Texture* getCachedFontTexture(TTF_Font* font, const char* text, SDL_Color color, int* width, int* height);
+void printTextCacheStats();
+void destroyTextCache();
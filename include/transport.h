@@ -0,0 +1,32 @@
+#pragma once
+#include <stddef.h>
+#include "framer.h"
+
+// Results of waitTransport
+#define TRANSPORT_RECEIVED 1
+#define TRANSPORT_WOKEN 2
+
+// Time given to a connection attempt before racing the next address (RFC 8305 recommends 250 ms)
+#define CONNECTION_ATTEMPT_DELAY 250
+
+enum ConnectionStageEnum {
+    RESOLVING,
+    RACING,
+    CONNECTED
+};
+
+typedef struct {
+    enum ConnectionStageEnum stage;
+    int addressCount;
+    int attempts;
+    unsigned long resolveMs;
+    unsigned long connectMs;
+    char address[64];
+} ConnectionTimings;
+
+void initTransport();
+void connectToServer(const char* address, long port, void (*progress)(const ConnectionTimings* timings));
+void sendToServer(const char* data, size_t length);
+int waitTransport(MessageFramer* framer, unsigned char wakeable);
+void wakeTransport();
+void closeTransport();
@@ -5,12 +5,20 @@
 
 #if(LANGUAGE == 0)
 #define CONNECTING_MSG "Connecting to %s..."
+#define CONNECTING_RESOLVED_MSG "Connecting to %s (%d addresses, DNS %lu ms)..."
+#define CONNECTING_CONNECTED_MSG "Connected to %s in %lu ms (DNS %lu ms). Saying hello..."
 #define CONNECTED_MSG "Connected. Waiting for a match..."
 #define PLACE_SHIPS_MSG "Opponent: %s. Place your ships by moving the mouse on your field."
-#define PLACE_SHIPS_ONGRID_MSG "Place your ships. Mouse left: place, mouse right: rotate, mouse middle: undo, mouse wheel: cycle through."
+#define PLACE_SHIPS_ONGRID_MSG "Place your ships. Mouse left: place, mouse right: rotate, mouse middle: undo, mouse wheel: cycle through, A: random fleet, O: optimized fleet."
+#define FLEET_INVALID_MSG "The last ship overlaps another one or leaves the field. Place it again."
+#define AUTO_PLACE_BUSY_MSG "Looking for a fleet that is hard to find..."
+#define AUTO_PLACE_FAILED_MSG "The fleet can't be placed automatically. Place the ships by hand."
+#define PLACE_SHIPS_NOWHERE_MSG "This ship doesn't fit anywhere like this. Rotate it, pick another one or undo a placement."
 #define WAIT_SHIPS_MSG "Waiting for %s to finish placing their ships..."
 #define ATTACK_MSG "It's your turn. Attack by moving the mouse on the opponent's field."
 #define ATTACK_ONGRID_MSG "Click to attack %c%d"
+#define ATTACK_REPEATED_MSG "You already attacked %c%d"
+#define AUTOPLAY_MSG "Autoplay: attacking %c%d"
 #define WAIT_TURN_MSG "It's %s's turn."
 #define YOU_WIN_MSG "You win!"
 #define YOU_LOSE_MSG "You lose"
@@ -18,12 +26,20 @@
 
 #if(LANGUAGE == 1)
 #define CONNECTING_MSG "Connessione a %s..."
+#define CONNECTING_RESOLVED_MSG "Connessione a %s (%d indirizzi, DNS %lu ms)..."
+#define CONNECTING_CONNECTED_MSG "Connesso a %s in %lu ms (DNS %lu ms). Invio saluto..."
 #define CONNECTED_MSG "Connesso. In attesa di un match..."
 #define PLACE_SHIPS_MSG "Avversario: %s. Posiziona le navi spostando il mouse sul tuo campo."
-#define PLACE_SHIPS_ONGRID_MSG "Posiziona le navi. Tasto sinistro: posiziona, tasto destro: ruota, tasto centrale: annulla azione, rotella: scorri le navi."
+#define PLACE_SHIPS_ONGRID_MSG "Posiziona le navi. Tasto sinistro: posiziona, tasto destro: ruota, tasto centrale: annulla azione, rotella: scorri le navi, A: flotta casuale, O: flotta ottimizzata."
+#define FLEET_INVALID_MSG "L'ultima nave si sovrappone a un'altra o esce dal campo. Posizionala di nuovo."
+#define AUTO_PLACE_BUSY_MSG "Ricerca di una flotta difficile da trovare..."
+#define AUTO_PLACE_FAILED_MSG "La flotta non puo' essere posizionata automaticamente. Posiziona le navi a mano."
+#define PLACE_SHIPS_NOWHERE_MSG "Questa nave non entra da nessuna parte cosi'. Ruotala, scegline un'altra o annulla un posizionamento."
 #define WAIT_SHIPS_MSG "Attendi che %s finisca di posizionare le proprie navi..."
 #define ATTACK_MSG "E' il tuo turno. Attacca spostando il mouse sul campo avversario."
 #define ATTACK_ONGRID_MSG "Clicca per attaccare %c%d"
+#define ATTACK_REPEATED_MSG "Hai gia' attaccato %c%d"
+#define AUTOPLAY_MSG "Gioco automatico: attacco %c%d"
 #define WAIT_TURN_MSG "E' il turno di %s."
 #define YOU_WIN_MSG "Hai vinto!"
 #define YOU_LOSE_MSG "Hai perso"
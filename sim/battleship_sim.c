@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "fleetfile.h"
+#include "placement.h"
+#include "rules.h"
+#include "strategyhost.h"
+#include "strategies.h"
+#include "workpool.h"
+
+// Plays bot-vs-bot matches with the client's ship, fleet and rules code, without SDL or sockets, and reports how every
+// targeting strategy does. Game i is played by the pairing i % pairings and seeded from the run's seed and i only, so
+// a run gives the same results whatever the number of threads.
+
+#define MAX_SIM_STRATEGIES 16
+
+typedef struct {
+	Ship ships[MAX_SHIPS];
+	Fleet fleet;
+	Bitboard hitsTaken; // Cells of the own fleet the opponent has hit
+	SimBoard board;     // What the player knows about the opponent's field
+	int shots;
+} SimPlayer;
+
+typedef struct {
+	long games;
+	long wins;
+	long shotsToWin;
+} StrategyStats;
+
+// Each worker adds up its own games; padded so that workers don't write to the same cache line
+typedef struct {
+	StrategyStats strategies[MAX_SIM_STRATEGIES];
+	char padding[64];
+} WorkerStats;
+
+typedef struct {
+	Bitboard grid;
+	int gridSize;
+	Ship* definitions[MAX_SHIPS];
+	int shipCount;
+	FleetPlacer placer;
+	StrategyShip strategyShips[MAX_SHIPS];
+	StrategyGame strategyGame; // The game as plugins see it
+	SimStrategy roster[MAX_SIM_STRATEGIES];
+	int rosterCount;
+	uint64_t seed;
+	int pairings[MAX_SIM_STRATEGIES * MAX_SIM_STRATEGIES][2];
+	int pairingCount;
+	WorkerStats* workers;
+} Simulation;
+
+static void playGame(long game, int worker, void* context) {
+	Simulation* simulation = context;
+	uint64_t rng = simulation->seed ^ ((uint64_t) game * 0xD1B54A32D192ED03ull);
+	const int* pairing = simulation->pairings[game % simulation->pairingCount];
+	const SimStrategy* strategies[2] = { &simulation->roster[pairing[0]], &simulation->roster[pairing[1]] };
+
+	SimPlayer players[2];
+	void* states[2] = { NULL, NULL };
+	for(int i = 0; i < 2; i++) {
+		const BattleshipStrategy* plugin = strategies[i]->plugin;
+		if(plugin != NULL) {
+			states[i] = plugin->create(&simulation->strategyGame, nextRandom(&rng));
+			if(states[i] == NULL) {
+				fprintf(stderr, "Error: strategy %s couldn't create its state in game %ld.\n", plugin->name, game);
+				exit(1);
+			}
+		}
+
+		// Plugins may place their own fleet; anything they get wrong is placed at random instead
+		FleetLayout layout;
+		Ship* ships[MAX_SHIPS];
+		StrategyPlacement placements[MAX_SHIPS];
+		unsigned char placed = plugin != NULL && plugin->placeFleet(states[i], placements)
+			&& getStrategyFleetLayout(placements, simulation->definitions, simulation->shipCount, &simulation->grid, &layout);
+		if(!placed && !sampleRandomFleet(&simulation->placer, &layout, &rng)) {
+			fprintf(stderr, "Error: couldn't fit the fleet in a %dx%d grid.\n", simulation->gridSize, simulation->gridSize);
+			exit(1);
+		}
+		clearFleet(&players[i].fleet);
+		for(int j = 0; j < simulation->shipCount; j++) {
+			players[i].ships[j] = *simulation->definitions[j];
+			ships[j] = &players[i].ships[j];
+		}
+		applyFleetLayout(&layout, ships, simulation->shipCount, &players[i].fleet);
+		memset(&players[i].board.view, 0, sizeof(players[i].board.view));
+		clearBitboard(&players[i].hitsTaken);
+		players[i].board.grid = &simulation->grid;
+		players[i].board.ships = (const Ship* const*) simulation->definitions;
+		players[i].board.shipCount = simulation->shipCount;
+		players[i].shots = 0;
+	}
+
+	// Both players of a pairing get to start half of the time
+	int turn = (int) (game / simulation->pairingCount % 2);
+	for(;;) {
+		SimPlayer* attacker = &players[turn];
+		SimPlayer* defender = &players[1 - turn];
+		int x, y;
+		if(strategies[turn]->plugin != NULL) {
+			unsigned char cells[BITBOARD_STRIDE * BITBOARD_MAX_SIZE];
+			getStrategyCells(cells, &attacker->board.view, simulation->gridSize, simulation->gridSize);
+			strategies[turn]->plugin->chooseAttack(states[turn], cells, &x, &y);
+		}
+		else {
+			strategies[turn]->chooseTarget(&attacker->board, &rng, &x, &y);
+		}
+		if(validateAttack(&attacker->board.view, &simulation->grid, x, y) != RULE_OK) {
+			fprintf(stderr, "Error: strategy %s chose an invalid attack on %d %d in game %ld.\n", strategies[turn]->name, x, y, game);
+			exit(1);
+		}
+		attacker->shots++;
+
+		Bitboard sunkShip;
+		enum AttackOutcomeEnum outcome = resolveAttack(&defender->fleet, &defender->hitsTaken, x, y, &sunkShip);
+		HitmapBuffer* view = &attacker->board.view;
+		if(outcome == ATTACK_MISS) {
+			setBit(&view->misses, x, y);
+		}
+		else {
+			setBit(&view->hits, x, y);
+			setBit(&defender->hitsTaken, x, y);
+		}
+		if(outcome == ATTACK_SUNK || outcome == ATTACK_FLEET_SUNK) {
+			// The server only says that a ship sank, so the attacker works out which cells it had like the client does
+			Bitboard guess;
+			findSunkShip(view, x, y, &guess);
+			orBitboard(&view->sunk, &guess);
+		}
+		if(strategies[turn]->plugin != NULL) {
+			int result = outcome == ATTACK_MISS ? STRATEGY_RESULT_MISS : outcome == ATTACK_HIT ? STRATEGY_RESULT_HIT : STRATEGY_RESULT_SUNK;
+			strategies[turn]->plugin->observe(states[turn], x, y, result);
+		}
+		if(outcome == ATTACK_FLEET_SUNK) break;
+		turn = 1 - turn;
+	}
+
+	for(int i = 0; i < 2; i++) {
+		if(states[i] != NULL) strategies[i]->plugin->destroy(states[i]);
+	}
+
+	StrategyStats* stats = simulation->workers[worker].strategies;
+	stats[pairing[0]].games++;
+	stats[pairing[1]].games++;
+	stats[pairing[turn]].wins++;
+	stats[pairing[turn]].shotsToWin += players[turn].shots;
+}
+
+static void printUsageAndQuit(char* programName) {
+	fprintf(stderr, "Usage: %s [-n <games>] [-j <threads>] [-s <seed>] [-g <grid size>] [-f <fleet file>] [-l <strategy plugin>]...\n"
+		"Defaults: 100000 games, one thread per core, seed 1, 10x10 grid, resources/fleet.txt.\n"
+		"Every -l adds a strategy plugin to the built-in strategies.\n", programName);
+	exit(1);
+}
+
+static double getSeconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+	long games = 100000;
+	int threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	char* fleetPath = "resources/fleet.txt";
+	Simulation simulation = { .seed = 1, .gridSize = 10 };
+	StrategyPlugin plugins[MAX_SIM_STRATEGIES];
+	int pluginCount = 0;
+	for(int i = 0; i < numberOfSimStrategies; i++) simulation.roster[simulation.rosterCount++] = simStrategies[i];
+
+	int option;
+	while((option = getopt(argc, argv, "n:j:s:g:f:l:")) != -1) {
+		switch(option) {
+		case 'n': games = atol(optarg); break;
+		case 'j': threads = atoi(optarg); break;
+		case 's': simulation.seed = strtoull(optarg, NULL, 10); break;
+		case 'g': simulation.gridSize = atoi(optarg); break;
+		case 'f': fleetPath = optarg; break;
+		case 'l':
+			if(simulation.rosterCount == MAX_SIM_STRATEGIES) {
+				fprintf(stderr, "Error: at most %d strategies can play.\n", MAX_SIM_STRATEGIES);
+				exit(1);
+			}
+			loadStrategyPlugin(&plugins[pluginCount], optarg);
+			simulation.roster[simulation.rosterCount].name = plugins[pluginCount].strategy->name;
+			simulation.roster[simulation.rosterCount].chooseTarget = NULL;
+			simulation.roster[simulation.rosterCount++].plugin = plugins[pluginCount++].strategy;
+			break;
+		default: printUsageAndQuit(argv[0]);
+		}
+	}
+	if(optind != argc || games <= 0 || threads <= 0 || simulation.gridSize < 1 || simulation.gridSize > BITBOARD_MAX_SIZE) {
+		printUsageAndQuit(argv[0]);
+	}
+
+	makeBoardMask(&simulation.grid, simulation.gridSize, simulation.gridSize);
+	simulation.shipCount = loadFleetFile(fleetPath, simulation.definitions);
+	if(!initFleetPlacer(&simulation.placer, simulation.definitions, simulation.shipCount, &simulation.grid)) {
+		fprintf(stderr, "Error: a ship of %s doesn't fit in a %dx%d grid.\n", fleetPath, simulation.gridSize, simulation.gridSize);
+		exit(1);
+	}
+	describeStrategyGame(&simulation.strategyGame, simulation.strategyShips, simulation.definitions, simulation.shipCount,
+		simulation.gridSize, simulation.gridSize);
+	for(int a = 0; a < simulation.rosterCount; a++) {
+		for(int b = 0; b < simulation.rosterCount; b++) {
+			if(a == b) continue;
+			simulation.pairings[simulation.pairingCount][0] = a;
+			simulation.pairings[simulation.pairingCount][1] = b;
+			simulation.pairingCount++;
+		}
+	}
+	simulation.workers = calloc(threads, sizeof(WorkerStats));
+	if(simulation.workers == NULL) {
+		fprintf(stderr, "Error: couldn't allocate memory for %d workers.\n", threads);
+		exit(1);
+	}
+
+	double start = getSeconds();
+	runWorkPool(games, threads, playGame, &simulation);
+	double elapsed = getSeconds() - start;
+
+	printf("Played %ld games in %.2f s (%.0f games/s) on %d threads, seed %llu.\n", games, elapsed, games / elapsed, threads,
+		(unsigned long long) simulation.seed);
+	printf("%-10s %10s %10s %9s %12s\n", "strategy", "games", "wins", "win rate", "shots to win");
+	for(int i = 0; i < simulation.rosterCount; i++) {
+		StrategyStats total = { 0 };
+		for(int w = 0; w < threads; w++) {
+			total.games += simulation.workers[w].strategies[i].games;
+			total.wins += simulation.workers[w].strategies[i].wins;
+			total.shotsToWin += simulation.workers[w].strategies[i].shotsToWin;
+		}
+		printf("%-10s %10ld %10ld %8.2f%% %12.2f\n", simulation.roster[i].name, total.games, total.wins,
+			total.games > 0 ? 100.0 * total.wins / total.games : 0.0, total.wins > 0 ? (double) total.shotsToWin / total.wins : 0.0);
+	}
+
+	free(simulation.workers);
+	for(int i = 0; i < pluginCount; i++) unloadStrategyPlugin(&plugins[i]);
+	for(int i = 0; i < simulation.shipCount; i++) freeShip(simulation.definitions[i]);
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include "strategies.h"
+#include "targeting.h"
+
+// Returns the index of a set bit of board chosen uniformly at random, or -1 if board is empty.
+int pickRandomBit(const Bitboard* board, uint64_t* rng) {
+	int count = countBits(board);
+	return count == 0 ? -1 : nthBit(board, randomBelow(rng, count));
+}
+
+void getUnattackedCells(const SimBoard* board, Bitboard* cells) {
+	*cells = *board->grid;
+	andNotBitboard(cells, &board->view.misses);
+	andNotBitboard(cells, &board->view.hits);
+}
+
+// Any cell that hasn't been attacked yet.
+static void chooseRandomTarget(const SimBoard* board, uint64_t* rng, int* x, int* y) {
+	Bitboard cells;
+	getUnattackedCells(board, &cells);
+	int bit = pickRandomBit(&cells, rng);
+	*x = bit % BITBOARD_STRIDE;
+	*y = bit / BITBOARD_STRIDE;
+}
+
+// Hunts on a checkerboard, since every ship at least 2 cells long covers one of its cells, and attacks the neighbours
+// of hits that don't belong to a sunk ship yet.
+static void chooseParityTarget(const SimBoard* board, uint64_t* rng, int* x, int* y) {
+	Bitboard cells;
+	getUnattackedCells(board, &cells);
+	Bitboard openHits = board->view.hits;
+	andNotBitboard(&openHits, &board->view.sunk);
+
+	Bitboard candidates;
+	clearBitboard(&candidates);
+	for(int bit = nextBit(&openHits, 0); bit != -1; bit = nextBit(&openHits, bit + 1)) {
+		int hitX = bit % BITBOARD_STRIDE;
+		int hitY = bit / BITBOARD_STRIDE;
+		if(hitX > 0) setBit(&candidates, hitX - 1, hitY);
+		if(hitX < BITBOARD_STRIDE - 1) setBit(&candidates, hitX + 1, hitY);
+		if(hitY > 0) setBit(&candidates, hitX, hitY - 1);
+		if(hitY < BITBOARD_MAX_SIZE - 1) setBit(&candidates, hitX, hitY + 1);
+	}
+	andBitboard(&candidates, &cells);
+
+	if(isBitboardEmpty(&candidates)) {
+		for(int bit = nextBit(&cells, 0); bit != -1; bit = nextBit(&cells, bit + 1)) {
+			if((bit % BITBOARD_STRIDE + bit / BITBOARD_STRIDE) % 2 == 0) setBit(&candidates, bit % BITBOARD_STRIDE, bit / BITBOARD_STRIDE);
+		}
+	}
+	if(isBitboardEmpty(&candidates)) candidates = cells;
+
+	int bit = pickRandomBit(&candidates, rng);
+	*x = bit % BITBOARD_STRIDE;
+	*y = bit / BITBOARD_STRIDE;
+}
+
+// The client's auto-play: the cell covered by most placements of the ships left.
+static void chooseDensityTarget(const SimBoard* board, uint64_t* rng, int* x, int* y) {
+	DensityMap map;
+	const Ship* remaining[MAX_SHIPS];
+	(void) rng;
+	int remainingCount = getRemainingShips(&board->view, (Ship* const*) board->ships, board->shipCount, remaining);
+	computeDensityMap(&map, &board->view, board->grid, remaining, remainingCount);
+	*x = map.bestX;
+	*y = map.bestY;
+}
+
+const SimStrategy simStrategies[] = {
+	{ "random", chooseRandomTarget, NULL },
+	{ "parity", chooseParityTarget, NULL },
+	{ "density", chooseDensityTarget, NULL }
+};
+const int numberOfSimStrategies = sizeof(simStrategies) / sizeof(simStrategies[0]);
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+#include "bitboard.h"
+#include "hitmap.h"
+#include "random.h"
+#include "ship.h"
+#include "strategy.h"
+
+// What a player knows about the opponent's field: the same misses, hits and sunk ships the client's hitmap holds.
+typedef struct {
+	HitmapBuffer view;
+	const Bitboard* grid;
+	const Ship* const* ships; // The fleet both players place, as defined in the fleet file
+	int shipCount;
+} SimBoard;
+
+// A built-in strategy, or a plugin when plugin isn't NULL
+typedef struct {
+	const char* name;
+	void (*chooseTarget)(const SimBoard* board, uint64_t* rng, int* x, int* y);
+	const BattleshipStrategy* plugin;
+} SimStrategy;
+
+extern const SimStrategy simStrategies[];
+extern const int numberOfSimStrategies;
+
+int pickRandomBit(const Bitboard* board, uint64_t* rng);
+void getUnattackedCells(const SimBoard* board, Bitboard* cells);
@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "workpool.h"
+
+// Items left to a worker; the owner takes from begin, thieves take from end.
+typedef struct {
+	pthread_mutex_t mutex;
+	long begin;
+	long end;
+} WorkQueue;
+
+typedef struct {
+	WorkQueue* queues;
+	int threads;
+	void (*run)(long item, int worker, void* context);
+	void* context;
+} WorkPool;
+
+typedef struct {
+	WorkPool* pool;
+	int worker;
+} Worker;
+
+// Takes the next item of the worker's own queue. Returns 0 if it's empty.
+static int takeItem(WorkQueue* queue, long* item) {
+	pthread_mutex_lock(&queue->mutex);
+	int taken = queue->begin < queue->end;
+	if(taken) *item = queue->begin++;
+	pthread_mutex_unlock(&queue->mutex);
+	return taken;
+}
+
+// Moves the back half of another worker's items (at least one) into the worker's own queue. Returns 0 if every other
+// queue is empty; since items are never added, the worker is done then.
+static int stealItems(WorkPool* pool, int worker) {
+	for(int i = 1; i < pool->threads; i++) {
+		WorkQueue* victim = &pool->queues[(worker + i) % pool->threads];
+		pthread_mutex_lock(&victim->mutex);
+		long left = victim->end - victim->begin;
+		long begin = victim->end - (left + 1) / 2;
+		long end = victim->end;
+		if(left > 0) victim->end = begin;
+		pthread_mutex_unlock(&victim->mutex);
+		if(left == 0) continue;
+
+		WorkQueue* own = &pool->queues[worker];
+		pthread_mutex_lock(&own->mutex);
+		own->begin = begin;
+		own->end = end;
+		pthread_mutex_unlock(&own->mutex);
+		return 1;
+	}
+	return 0;
+}
+
+static void* runWorker(void* argument) {
+	Worker* worker = argument;
+	WorkPool* pool = worker->pool;
+	long item;
+	do {
+		while(takeItem(&pool->queues[worker->worker], &item)) pool->run(item, worker->worker, pool->context);
+	} while(stealItems(pool, worker->worker));
+	return NULL;
+}
+
+void runWorkPool(long items, int threads, void (*run)(long item, int worker, void* context), void* context) {
+	WorkPool pool = { .queues = calloc(threads, sizeof(WorkQueue)), .threads = threads, .run = run, .context = context };
+	Worker* workers = calloc(threads, sizeof(Worker));
+	pthread_t* handles = calloc(threads, sizeof(pthread_t));
+	if(pool.queues == NULL || workers == NULL || handles == NULL) {
+		fprintf(stderr, "Error: couldn't allocate memory for %d workers.\n", threads);
+		exit(1);
+	}
+
+	for(int i = 0; i < threads; i++) {
+		pthread_mutex_init(&pool.queues[i].mutex, NULL);
+		pool.queues[i].begin = items * i / threads;
+		pool.queues[i].end = items * (i + 1) / threads;
+		workers[i].pool = &pool;
+		workers[i].worker = i;
+	}
+	for(int i = 0; i < threads; i++) {
+		if(pthread_create(&handles[i], NULL, runWorker, &workers[i]) != 0) {
+			fprintf(stderr, "Error: couldn't start worker thread %d.\n", i);
+			exit(1);
+		}
+	}
+	for(int i = 0; i < threads; i++) {
+		pthread_join(handles[i], NULL);
+		pthread_mutex_destroy(&pool.queues[i].mutex);
+	}
+
+	free(handles);
+	free(workers);
+	free(pool.queues);
+}
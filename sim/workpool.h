@@ -0,0 +1,6 @@
+#pragma once
+#include <pthread.h>
+
+// Runs run(item, worker, context) for every item in [0, items) on threads workers. Every worker starts with an equal
+// share of the items and, once it has finished it, steals the back half of another worker's remaining items.
+void runWorkPool(long items, int threads, void (*run)(long item, int worker, void* context), void* context);
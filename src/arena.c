@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+
+// Reserves the whole capacity of the arena up front, so that memory use doesn't depend on how long a session lasts.
+void initArena(Arena* arena, size_t capacity) {
+	arena->base = malloc(capacity);
+	if(arena->base == NULL) {
+		printf("Error: couldn't allocate memory for an arena of %zu bytes.\n", capacity);
+		exit(1);
+	}
+	arena->capacity = capacity;
+	arena->used = 0;
+	arena->highWater = 0;
+	for(int i = 0; i < MEM_TAG_COUNT; i++) {
+		arena->taggedBytes[i] = 0;
+		arena->taggedCount[i] = 0;
+	}
+}
+
+// Allocates size bytes from the arena on behalf of tag; they stay valid until the arena is reset.
+void* arenaAlloc(Arena* arena, size_t size, enum MemTagEnum tag) {
+	size_t aligned = (size + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1);
+	if(aligned < size || arena->capacity - arena->used < aligned) {
+		printf("Error: arena out of memory: %zu bytes requested, %zu of %zu bytes used.\n", size, arena->used, arena->capacity);
+		exit(1);
+	}
+	void* memory = arena->base + arena->used;
+	arena->used += aligned;
+	if(arena->used > arena->highWater) arena->highWater = arena->used;
+	arena->taggedBytes[tag] += aligned;
+	arena->taggedCount[tag]++;
+	recordAllocation(tag, aligned);
+	return memory;
+}
+
+// Releases everything allocated from the arena. The high-water mark is kept across resets.
+void resetArena(Arena* arena) {
+	arena->used = 0;
+	for(int i = 0; i < MEM_TAG_COUNT; i++) {
+		recordRelease(i, arena->taggedBytes[i], arena->taggedCount[i]);
+		arena->taggedBytes[i] = 0;
+		arena->taggedCount[i] = 0;
+	}
+}
+
+void freeArena(Arena* arena) {
+	resetArena(arena);
+	free(arena->base);
+	arena->base = NULL;
+	arena->capacity = 0;
+	arena->used = 0;
+}
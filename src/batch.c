@@ -0,0 +1,88 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "globals.h"
+#include "batch.h"
+
+SpriteBatch spriteBatch;
+
+// Queues a quad showing srcrect of texture (the whole texture if NULL) at dstrect, rotated clockwise by angle
+// degrees around its center and modulated by color.
+// Consecutive quads from the same texture are submitted together with a single SDL_RenderGeometry call;
+// switching texture submits the pending ones first, so the drawing order is preserved.
+void batchQuad(SDL_Texture* texture, const SDL_Rect* srcrect, const SDL_FRect* dstrect, double angle, SDL_Color color) {
+	if(texture != spriteBatch.texture || spriteBatch.count == SPRITE_BATCH_SIZE) {
+		flushBatch();
+		if(SDL_QueryTexture(texture, NULL, NULL, &spriteBatch.textureWidth, &spriteBatch.textureHeight) < 0) {
+			printf("Error: couldn't get texture width and height:\n%s", SDL_GetError());
+			exit(1);
+		}
+		spriteBatch.texture = texture;
+	}
+
+	float u0 = 0, v0 = 0, u1 = 1, v1 = 1;
+	if(srcrect != NULL) {
+		u0 = (float) srcrect->x / spriteBatch.textureWidth;
+		v0 = (float) srcrect->y / spriteBatch.textureHeight;
+		u1 = (float) (srcrect->x + srcrect->w) / spriteBatch.textureWidth;
+		v1 = (float) (srcrect->y + srcrect->h) / spriteBatch.textureHeight;
+	}
+
+	// Corners relative to the center, clockwise from the top left one
+	float halfW = dstrect->w / 2, halfH = dstrect->h / 2;
+	float cx = dstrect->x + halfW, cy = dstrect->y + halfH;
+	float dx[4] = { -halfW, halfW, halfW, -halfW };
+	float dy[4] = { -halfH, -halfH, halfH, halfH };
+	float cosA = 1, sinA = 0;
+	if(angle != 0) {
+		double radians = angle * M_PI / 180;
+		cosA = (float) SDL_cos(radians);
+		sinA = (float) SDL_sin(radians);
+	}
+
+	SDL_Vertex* v = &spriteBatch.vertices[4 * spriteBatch.count];
+	SDL_FPoint uv[4] = { { u0, v0 }, { u1, v0 }, { u1, v1 }, { u0, v1 } };
+	for(int i = 0; i < 4; i++) {
+		v[i].position.x = cx + dx[i] * cosA - dy[i] * sinA;
+		v[i].position.y = cy + dx[i] * sinA + dy[i] * cosA;
+		v[i].color = color;
+		v[i].tex_coord = uv[i];
+	}
+
+	int* index = &spriteBatch.indices[6 * spriteBatch.count];
+	int base = 4 * spriteBatch.count;
+	index[0] = base; index[1] = base + 1; index[2] = base + 2;
+	index[3] = base; index[4] = base + 2; index[5] = base + 3;
+
+	spriteBatch.count++;
+	spriteBatch.currentFrame.quads++;
+}
+
+// Submits the pending quads. Must be called before anything is drawn without going through the batch,
+// and before changing render target.
+void flushBatch() {
+	SDL_Texture* texture = spriteBatch.texture;
+	spriteBatch.texture = NULL; // Textures may be destroyed after this, so their size is queried again on the next batch
+	if(spriteBatch.count == 0) return;
+	if(SDL_RenderGeometry(renderer, texture, spriteBatch.vertices, 4 * spriteBatch.count, spriteBatch.indices, 6 * spriteBatch.count) < 0) {
+		printf("Error: couldn't copy texture to window:\n%s", SDL_GetError());
+		exit(1);
+	}
+	spriteBatch.count = 0;
+	spriteBatch.currentFrame.drawCalls++;
+}
+
+// Submits what's left of the frame, shows it and records its statistics.
+void presentFrame() {
+	flushBatch();
+	SDL_RenderPresent(renderer);
+	spriteBatch.lastFrame = spriteBatch.currentFrame;
+	spriteBatch.currentFrame.drawCalls = 0;
+	spriteBatch.currentFrame.quads = 0;
+	spriteBatch.frame++;
+}
+
+// Prints how many draw calls and quads the last presented frame was made of.
+void printFrameStats() {
+	printf("Frame %lu: %lu draw calls, %lu quads.\n", spriteBatch.frame, spriteBatch.lastFrame.drawCalls, spriteBatch.lastFrame.quads);
+}
@@ -0,0 +1,99 @@
+#include "bitboard.h"
+
+// Sets exactly the bits of the cells inside a rows x cols grid.
+void makeBoardMask(Bitboard* board, int rows, int cols) {
+	clearBitboard(board);
+	uint64_t rowMask = cols >= 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << cols) - 1;
+	for(int y = 0; y < rows; y++) {
+		int bit = getBitIndex(0, y);
+		board->words[bit / 64] |= rowMask << (bit % 64);
+	}
+}
+
+// Moves every cell of src by x columns and y rows. Cells pushed past the last word are dropped, so callers must
+// make sure the shape stays within BITBOARD_STRIDE columns, otherwise it wraps into the next row.
+void shiftBitboard(Bitboard* dst, const Bitboard* src, int x, int y) {
+	int shift = getBitIndex(x, y);
+	int wordShift = shift / 64;
+	int bitShift = shift % 64;
+	for(int i = BITBOARD_WORDS - 1; i >= 0; i--) {
+		uint64_t word = 0;
+		if(i - wordShift >= 0) {
+			word = src->words[i - wordShift] << bitShift;
+			if(bitShift != 0 && i - wordShift - 1 >= 0) word |= src->words[i - wordShift - 1] >> (64 - bitShift);
+		}
+		dst->words[i] = word;
+	}
+}
+
+int countBits(const Bitboard* board) {
+	int count = 0;
+	for(int i = 0; i < BITBOARD_WORDS; i++) count += __builtin_popcountll(board->words[i]);
+	return count;
+}
+
+// Returns the index of the first set bit at or after from, or -1 if there is none.
+int nextBit(const Bitboard* board, int from) {
+	for(int i = from / 64; i < BITBOARD_WORDS; i++) {
+		uint64_t word = board->words[i];
+		if(i == from / 64) word &= ~(uint64_t) 0 << (from % 64);
+		if(word != 0) return i * 64 + __builtin_ctzll(word);
+	}
+	return -1;
+}
+
+// Returns the index of the set bit that has n set bits before it, or -1 if there are at most n set bits.
+int nthBit(const Bitboard* board, int n) {
+	for(int i = 0; i < BITBOARD_WORDS; i++) {
+		uint64_t word = board->words[i];
+		int count = __builtin_popcountll(word);
+		if(n >= count) {
+			n -= count;
+			continue;
+		}
+		while(n-- > 0) word &= word - 1;
+		return i * 64 + __builtin_ctzll(word);
+	}
+	return -1;
+}
+
+// Sets in dst the cells of src connected to (x, y) through their sides. (x, y) must be set in src.
+void floodFillBitboard(Bitboard* dst, const Bitboard* src, int x, int y) {
+	Bitboard candidates = *src;
+	clearBitboard(dst);
+
+	int stack[BITBOARD_STRIDE * BITBOARD_MAX_SIZE];
+	int size = 0;
+	stack[size++] = getBitIndex(x, y);
+	clearBit(&candidates, x, y);
+	while(size > 0) {
+		int bit = stack[--size];
+		int cellX = bit % BITBOARD_STRIDE;
+		int cellY = bit / BITBOARD_STRIDE;
+		setBit(dst, cellX, cellY);
+		const int neighbours[4][2] = { { cellX - 1, cellY }, { cellX + 1, cellY }, { cellX, cellY - 1 }, { cellX, cellY + 1 } };
+		for(int i = 0; i < 4; i++) {
+			int nx = neighbours[i][0];
+			int ny = neighbours[i][1];
+			if(nx < 0 || nx >= BITBOARD_STRIDE || ny < 0 || ny >= BITBOARD_MAX_SIZE || !testBit(&candidates, nx, ny)) continue;
+			clearBit(&candidates, nx, ny);
+			stack[size++] = getBitIndex(nx, ny);
+		}
+	}
+}
+
+// Finds the set bit closest to cell (x, y). Returns 0 if the board is empty.
+unsigned char findNearestBit(const Bitboard* board, int x, int y, int* nearestX, int* nearestY) {
+	int bestDistance = -1;
+	for(int bit = nextBit(board, 0); bit != -1; bit = nextBit(board, bit + 1)) {
+		int dx = bit % BITBOARD_STRIDE - x;
+		int dy = bit / BITBOARD_STRIDE - y;
+		int distance = dx * dx + dy * dy;
+		if(bestDistance == -1 || distance < bestDistance) {
+			bestDistance = distance;
+			*nearestX = bit % BITBOARD_STRIDE;
+			*nearestY = bit / BITBOARD_STRIDE;
+		}
+	}
+	return bestDistance != -1;
+}
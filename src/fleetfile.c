@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fleetfile.h"
+
+// Adds a ship read from a fleet definition file, where shipLine is the line defining it. Its cells must be
+// connected through their sides.
+static void addFileShip(const char* path, int shipLine, Ship* definitions[MAX_SHIPS], int index, const char* name, char rows[SHIP_MATRIX_SIZE][SHIP_MATRIX_SIZE + 1], int height) {
+	addShipDefinition(definitions, index, name, rows, height);
+	const Bitboard* shape = &getShipOrientation(definitions[index])->shape;
+	int first = nextBit(shape, 0);
+	Bitboard connected;
+	floodFillBitboard(&connected, shape, first % BITBOARD_STRIDE, first / BITBOARD_STRIDE);
+	if(countBits(&connected) != countBits(shape)) {
+		printf("Error: %s:%d: the cells of ship %s aren't connected.\n", path, shipLine, name);
+		exit(1);
+	}
+}
+
+// Loads the fleet definition file at path into definitions and returns how many ships it defines. Every ship starts
+// with a "ship <name>" line, followed by one line per row of its shape: F, M and B are ship parts and . is an empty
+// cell. Lines starting with # are comments.
+int loadFleetFile(const char* path, Ship* definitions[MAX_SHIPS]) {
+	FILE* file = fopen(path, "r");
+	if(file == NULL) {
+		printf("Error: couldn't open fleet definition file %s.\n", path);
+		exit(1);
+	}
+
+	int count = 0;
+	char line[256];
+	char name[20] = "";
+	char shape[SHIP_MATRIX_SIZE][SHIP_MATRIX_SIZE + 1];
+	int height = 0;
+	int lineNumber = 0;
+	int shipLine = 0;
+	unsigned char inShip = 0;
+	while(fgets(line, sizeof(line), file) != NULL) {
+		lineNumber++;
+		line[strcspn(line, "\r\n")] = '\0';
+		if(line[0] == '#') continue;
+
+		if(strncmp(line, "ship ", 5) == 0) {
+			if(inShip) addFileShip(path, shipLine, definitions, count++, name, shape, height);
+			// Names are sent as a single token by the text protocol
+			size_t length = strlen(line + 5);
+			if(length == 0 || length >= sizeof(name) || strcspn(line + 5, " \t") != length) {
+				printf("Error: %s:%d: ship names must be 1 to %d characters long, without spaces.\n", path, lineNumber, (int) sizeof(name) - 1);
+				exit(1);
+			}
+			strcpy(name, line + 5);
+			shipLine = lineNumber;
+			height = 0;
+			inShip = 1;
+		}
+		else if(line[0] == '\0') {
+			continue;
+		}
+		else if(!inShip || height == SHIP_MATRIX_SIZE || strlen(line) > SHIP_MATRIX_SIZE || strspn(line, "FMB.") != strlen(line)) {
+			printf("Error: %s:%d: expected a ship row of at most %d F, M, B or . characters.\n", path, lineNumber, SHIP_MATRIX_SIZE);
+			exit(1);
+		}
+		else {
+			strcpy(shape[height++], line);
+		}
+	}
+	fclose(file);
+	if(inShip) addFileShip(path, shipLine, definitions, count++, name, shape, height);
+
+	if(count == 0) {
+		printf("Error: fleet definition file %s doesn't define any ship.\n", path);
+		exit(1);
+	}
+	return count;
+}
+
+// Makes a ship from the rows of its shape, centered in the ship matrix, and stores it as definitions[index].
+void addShipDefinition(Ship* definitions[MAX_SHIPS], int index, const char* name, char rows[SHIP_MATRIX_SIZE][SHIP_MATRIX_SIZE + 1], int height) {
+	if(index == MAX_SHIPS) {
+		printf("Error: a fleet can have at most %d ships.\n", MAX_SHIPS);
+		exit(1);
+	}
+	int width = 0;
+	for(int y = 0; y < height; y++) {
+		if((int) strlen(rows[y]) > width) width = strlen(rows[y]);
+	}
+
+	Ship* ship = makeShip(name, index, SHIP_MATRIX_SIZE, SHIP_MATRIX_SIZE);
+	int top = (SHIP_MATRIX_SIZE - height) / 2;
+	int left = (SHIP_MATRIX_SIZE - width) / 2;
+	for(int y = 0; y < height; y++) {
+		for(int x = 0; rows[y][x] != '\0'; x++) {
+			if(rows[y][x] != '.') ship->matrix[top + y][left + x] = rows[y][x];
+		}
+	}
+	buildShipOrientations(ship);
+	if(getShipOrientation(ship)->partCount == 0) {
+		printf("Error: ship %s has no parts.\n", name);
+		exit(1);
+	}
+
+	definitions[index] = ship;
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "framer.h"
+
+void initFramer(MessageFramer* framer) {
+    framer->binary = 0;
+    framer->start = 0;
+    framer->end = 0;
+    framer->scanned = 0;
+}
+
+// Returns where the next received bytes must be written, and how many fit there.
+// If the free space at the end of the buffer is running out, the leftover bytes (the beginning of a message
+// that hasn't been completely received yet) are moved to the front; complete messages are never moved,
+// but views returned by nextMessage are only valid until this is called again.
+char* getFramerWriteSpace(MessageFramer* framer, size_t* available) {
+    if(framer->start > 0 && FRAMER_CAPACITY - framer->end < FRAMER_CAPACITY / 4) {
+        size_t leftover = framer->end - framer->start;
+        memmove(framer->buffer, framer->buffer + framer->start, leftover);
+        framer->start = 0;
+        framer->end = leftover;
+    }
+    if(framer->end == FRAMER_CAPACITY) {
+        fprintf(stderr, "Error: server sent a message bigger than %d bytes.\n", FRAMER_CAPACITY);
+        exit(1);
+    }
+    *available = FRAMER_CAPACITY - framer->end;
+    return framer->buffer + framer->end;
+}
+
+// Marks length bytes written after getFramerWriteSpace as received.
+void commitFramerWrite(MessageFramer* framer, size_t length) {
+    framer->end += length;
+}
+
+// Extracts the next complete length-prefixed frame, without its length, as a view into the framer's buffer.
+static unsigned char nextBinaryFrame(MessageFramer* framer, MessageView* message) {
+    if(framer->end - framer->start < 2) return 0;
+    const unsigned char* header = (const unsigned char*) framer->buffer + framer->start;
+    size_t length = ((size_t) header[0] << 8) | header[1];
+    if(framer->end - framer->start < 2 + length) return 0;
+    message->data = framer->buffer + framer->start + 2;
+    message->length = length;
+    framer->start += 2 + length;
+    return 1;
+}
+
+// Extracts the next complete message, without its terminator, as a view into the framer's buffer.
+// Returns 0 if no complete message has been received yet; the partial one is kept for later.
+unsigned char nextMessage(MessageFramer* framer, MessageView* message) {
+    if(framer->binary) return nextBinaryFrame(framer, message);
+
+    // Skip what separates messages: blank lines and the NUL terminator some peers send after each message
+    while(framer->start < framer->end && framer->scanned == 0) {
+        char c = framer->buffer[framer->start];
+        if(c != '\0' && c != '\r' && c != '\n') break;
+        framer->start++;
+    }
+
+    // Only scan bytes that haven't been scanned yet, plus the ones that could begin a split terminator
+    size_t from = framer->start + (framer->scanned > 3 ? framer->scanned - 3 : 0);
+    for(size_t i = from; i + 4 <= framer->end; i++) {
+        if(memcmp(framer->buffer + i, "\r\n\r\n", 4) == 0) {
+            message->data = framer->buffer + framer->start;
+            message->length = i - framer->start;
+            framer->start = i + 4;
+            framer->scanned = 0;
+            return 1;
+        }
+    }
+    framer->scanned = framer->end - framer->start;
+    return 0;
+}
+
+// Extracts the next non-empty line of message and advances message past it.
+// Returns 0 if there are no more lines.
+unsigned char nextLine(MessageView* message, MessageView* line) {
+    while(message->length > 0 && (message->data[0] == '\r' || message->data[0] == '\n')) {
+        message->data++;
+        message->length--;
+    }
+    if(message->length == 0) return 0;
+
+    size_t length = 0;
+    while(length < message->length && message->data[length] != '\r' && message->data[length] != '\n') length++;
+    line->data = message->data;
+    line->length = length;
+    message->data += length;
+    message->length -= length;
+    return 1;
+}
+
+// Extracts the next space-separated token of line and advances line past it.
+// Returns 0 if there are no more tokens.
+unsigned char nextToken(MessageView* line, MessageView* token) {
+    while(line->length > 0 && line->data[0] == ' ') {
+        line->data++;
+        line->length--;
+    }
+    if(line->length == 0) return 0;
+
+    size_t length = 0;
+    while(length < line->length && line->data[length] != ' ') length++;
+    token->data = line->data;
+    token->length = length;
+    line->data += length;
+    line->length -= length;
+    return 1;
+}
+
+// Returns 1 if view contains exactly str.
+unsigned char viewEquals(MessageView view, const char* str) {
+    size_t length = strlen(str);
+    return view.length == length && memcmp(view.data, str, length) == 0;
+}
+
+// Parses view as a decimal integer. Returns 0 if it isn't one.
+unsigned char parseViewInt(MessageView view, int* value) {
+    size_t i = 0;
+    int sign = 1;
+    long result = 0;
+    if(view.length > 0 && view.data[0] == '-') {
+        sign = -1;
+        i++;
+    }
+    if(i == view.length) return 0;
+    for(; i < view.length; i++) {
+        if(view.data[i] < '0' || view.data[i] > '9') return 0;
+        result = result * 10 + (view.data[i] - '0');
+        if(result > 1000000000L) return 0;
+    }
+    *value = (int) (sign * result);
+    return 1;
+}
@@ -7,18 +7,50 @@
 #include "globals.h"
 #include "userstrings.h"
 #include "network.h"
+#include "textcache.h"
+#include "glyphatlas.h"
+#include "batch.h"
+#include "rules.h"
+#include "memstats.h"
+#include "placement.h"
+#include "strategyhost.h"
+#include "random.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 
 void gameLoop() {
-	int fps = 30;
-	Uint32 tickTime = (Uint32) (1000 / fps);
+	// Presenting blocks until the display refreshes with vsync; without it frames are capped to MAX_FPS instead
+	SDL_RendererInfo info;
+	unsigned char vsync = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+	Uint32 frameTime = (Uint32) (1000 / MAX_FPS);
 	Uint32 nextTime = 0;
 	enum NetworkStateEnum ns;
 	char state = 0;
+	unsigned char matchEnded = 0;
 
 	while(!(state & STOP_RUNNING)) {
+		// Sleep until there's something to react to: input, window events or a change posted by the network thread.
+		// The event is left in the queue for the scene to handle.
+		if(!SDL_WaitEvent(NULL)) {
+			printf("Error: couldn't wait for events:\n%s", SDL_GetError());
+			exit(1);
+		}
+
+		if(SDL_GetWindowFlags(window) & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED)) { // Nothing to show, only handle events
+			SDL_Event ev;
+			state = 0;
+			while(SDL_PollEvent(&ev)) {
+				state |= handleEvent(ev);
+			}
+			continue;
+		}
+
 		ns = getNetworkState();
+		if((ns == WON || ns == LOST) && !matchEnded) {
+			endMatch();
+			matchEnded = 1;
+		}
 		switch(ns) {
 		case CONNECTING:
 			state = runConnectingScene();
@@ -49,8 +81,11 @@ void gameLoop() {
 			exit(1);
 		}
 		if(state & END_SCENE) currentScene++;
-		SDL_Delay(getTimeLeft(nextTime));
-		nextTime += tickTime;
+		autoPlaceRequest = AUTO_PLACE_NONE; // Only the placement scene acts on it, and only in the frame it was pressed
+		if(!vsync) {
+			SDL_Delay(getTimeLeft(nextTime));
+			nextTime = SDL_GetTicks() + frameTime;
+		}
 	}
 }
 
@@ -87,8 +122,30 @@ char handleEvent(SDL_Event ev) {
 			return MOUSE_WHEEL_DOWN;
 		}
 	}
+	else if(ev.type == SDL_RENDER_TARGETS_RESET || ev.type == SDL_RENDER_DEVICE_RESET) {
+		invalidateBoardLayer();
+	}
 	else if(ev.type == SDL_KEYDOWN) {
 		switch(ev.key.keysym.sym) {
+		case SDLK_F3:
+			printFrameStats();
+			printTextCacheStats();
+			return 0;
+		case SDLK_F4:
+			printMemoryReport(stdout);
+			return 0;
+		case SDLK_F5:
+			showTargetHint = !showTargetHint;
+			return 0;
+		case SDLK_F6:
+			autoPlay = !autoPlay;
+			return 0;
+		case SDLK_a:
+			autoPlaceRequest = AUTO_PLACE_RANDOM;
+			return 0;
+		case SDLK_o:
+			autoPlaceRequest = AUTO_PLACE_OPTIMIZED;
+			return 0;
 		default:
 			return 0;
 		}
@@ -104,12 +161,11 @@ void convertMouseCoordsToGrid(int mouseX, int mouseY, int xOffset, int yOffset,
 void setStatusBar(const char* text) {
 	int fontWidth, fontHeight;
 	SDL_Color c = {255, 255, 255, 255};
-	SDL_Texture* texture = getFontTexture(mainFont, text, c);
+	SDL_Texture* texture = NULL;
 
-	if(SDL_QueryTexture(texture, NULL, NULL, &fontWidth, &fontHeight) < 0) {
-		printf("Error: couldn't get font width and height:\n%s", SDL_GetError());
-		exit(1);
-	}
+	// Text the glyph atlas can't draw (e.g. a nickname with non-ASCII characters) goes through the text cache
+	if(canDrawText(text)) measureText(text, &fontWidth, &fontHeight);
+	else texture = getCachedFontTexture(mainFont, text, c, &fontWidth, &fontHeight);
 
 	int usedWidth = fontWidth, usedHeight = 30, usedY = squareHeight * rows + squareHeight + 10;
 
@@ -119,71 +175,195 @@ void setStatusBar(const char* text) {
 		usedY = squareHeight * rows + squareHeight + ((squareHeight - usedHeight) / 2);
 	}
 	SDL_Rect r = {.x = 10, .y = usedY, .w = usedWidth, .h = usedHeight};
-	renderCopy(texture, &r, 0);
-	SDL_DestroyTexture(texture);
+	if(texture != NULL) renderCopy(texture, &r, 0);
+	else drawText(text, &r, c);
+}
+
+// Draws both grids with their coordinate labels.
+// None of it changes during a match, so it's composited once into boardLayer and every frame only blits that;
+// the layer is rebuilt whenever the board geometry differs from the one it was composited with.
+void drawBoard() {
+	int gridWidth = squareWidth * cols;
+	SDL_Rect r = { .x = 0, .y = 0, .w = 2 * gridWidth + 2 * squareWidth, .h = squareHeight * (rows + 1) };
+
+	if(!SDL_RenderTargetSupported(renderer)) { // Fall back to drawing the board directly every frame
+		composeBoard();
+		return;
+	}
+
+	if(boardLayer == NULL || boardLayerSquareWidth != squareWidth || boardLayerSquareHeight != squareHeight || boardLayerCols != cols || boardLayerRows != rows) {
+		renderBoardLayer(r.w, r.h);
+	}
+	renderCopy(boardLayer, &r, 0);
+}
+
+// Draws the grids and coordinate labels onto the current render target.
+void composeBoard() {
+	int gridWidth = squareWidth * cols;
+	drawGrid(squareWidth, squareHeight);
+	drawGrid(gridWidth + 2 * squareWidth, squareHeight);
+	drawGridCoords(0, 0, 0);
+	drawGridCoords(gridWidth + squareWidth, 0, 1);
+}
+
+// (Re)creates boardLayer with the given size and composites the board into it.
+void renderBoardLayer(int width, int height) {
+	invalidateBoardLayer();
+	boardLayer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+	if(boardLayer == NULL) {
+		printf("Error: couldn't create board layer texture:\n%s", SDL_GetError());
+		exit(1);
+	}
+	trackTexture(MEM_ASSETS, boardLayer);
+	// The layer is cleared to the opaque window background and copied as is, so that edges are blended only once,
+	// against the same color as when the board is drawn directly
+	SDL_SetTextureBlendMode(boardLayer, SDL_BLENDMODE_NONE);
+	flushBatch();
+	if(SDL_SetRenderTarget(renderer, boardLayer) < 0) {
+		printf("Error: couldn't render to board layer texture:\n%s", SDL_GetError());
+		exit(1);
+	}
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	composeBoard();
+	flushBatch();
+	SDL_SetRenderTarget(renderer, NULL);
+
+	boardLayerSquareWidth = squareWidth;
+	boardLayerSquareHeight = squareHeight;
+	boardLayerCols = cols;
+	boardLayerRows = rows;
+}
+
+// Drops boardLayer so that it's composited again on the next drawBoard.
+// Must also be called when the renderer loses its render targets.
+void invalidateBoardLayer() {
+	if(boardLayer != NULL) {
+		destroyTrackedTexture(MEM_ASSETS, boardLayer);
+		boardLayer = NULL;
+	}
 }
 
 void drawGrid(int xOffset, int yOffset) {
 	for(int x = 0; x < cols; x++) {
 		for(int y = 0; y < rows; y++) {
-			SDL_Texture* currentSquare;
-			if(((x % 2) != 0) ^ ((y % 2) != 0)) currentSquare = gridSquareB;
-			else currentSquare = gridSquareA;
+			enum SpriteEnum currentSquare;
+			if(((x % 2) != 0) ^ ((y % 2) != 0)) currentSquare = GRID_SQUARE_B_SPRITE;
+			else currentSquare = GRID_SQUARE_A_SPRITE;
 			SDL_Rect r = { .x = xOffset + x * squareWidth, .y = yOffset + y * squareHeight, .w = squareWidth, .h = squareHeight };
-			renderCopy(currentSquare, &r, 0);
+			renderSprite(currentSquare, &r, 0);
 		}
 	}
 }
 
 void drawGridCoords(int xOffset, int yOffset, int labelSet) {
+	SDL_Color labelColors[2] = { {0, 255, 217, 255}, {255, 136, 0, 255} };
+	char label[12];
 	for(int x = 1; x <= cols; x++) {
-		SDL_Texture* texture = gridColLabels[cols * labelSet + x - 1];
+		label[0] = 64 + x;
+		label[1] = '\0';
 		int fontWidth, fontHeight;
-		if(SDL_QueryTexture(texture, NULL, NULL, &fontWidth, &fontHeight) < 0) {
-			printf("Error: couldn't get font width and height:\n%s", SDL_GetError());
-			exit(1);
-		}
+		measureText(label, &fontWidth, &fontHeight);
 		SDL_Rect r = { .x = xOffset + x * squareWidth + squareWidth / 2 - fontWidth / 2,.y = yOffset + squareHeight / 2 - fontHeight / 2,.w = fontWidth,.h = fontHeight };
-		renderCopy(texture, &r, 0);
+		drawText(label, &r, labelColors[labelSet]);
 	}
 	for(int y = 1; y <= rows; y++) {
-		SDL_Texture* texture = gridRowLabels[rows * labelSet + y - 1];
+		snprintf(label, sizeof(label), "%d", y);
 		int fontWidth, fontHeight;
-		if(SDL_QueryTexture(texture, NULL, NULL, &fontWidth, &fontHeight) < 0) {
-			printf("Error: couldn't get font width and height:\n%s", SDL_GetError());
-			exit(1);
-		}
+		measureText(label, &fontWidth, &fontHeight);
 		SDL_Rect r = { .x = xOffset + squareWidth / 2 - fontWidth / 2,.y = yOffset + y * squareHeight + squareHeight / 2 - fontHeight / 2,.w = fontWidth,.h = fontHeight };
-		renderCopy(texture, &r, 0);
+		drawText(label, &r, labelColors[labelSet]);
 	}
 }
 
+// Draws an overlay on every marked cell. The hitmap is read through a lock-free snapshot, and its set bits are only
+// walked again when the network thread has published a new version.
 void drawHitmap(Hitmap* hitmap, int xOffset, int yOffset) {
-	for(int x = 0; x < cols; x++) {
-		for(int y = 0; y < rows; y++) {
-			SDL_Texture* currentOverlay;
-
-			char field = getHitmapField(hitmap, x, y);
-			switch(field) {
-				case 0: continue;
-				case 1:
-					currentOverlay = missedOverlay;
-					break;
-				case 2:
-					currentOverlay = hitOverlay;
-					break;
-				default:
-					fprintf(stderr, "Error: invalid hitmap field.\n");
-					exit(1);
-			}
-			
-			SDL_Rect r = { .x = xOffset + x * squareWidth, .y = yOffset + y * squareHeight, .w = squareWidth, .h = squareHeight };
-			renderCopy(currentOverlay, &r, 0);
+	unsigned int version = atomic_load_explicit(&hitmap->version, memory_order_acquire);
+	if(version != hitmap->drawnVersion) {
+		HitmapBuffer snapshot;
+		hitmap->drawnVersion = getHitmapSnapshot(hitmap, &snapshot);
+		hitmap->drawnCount = 0;
+		for(int bit = nextBit(&snapshot.misses, 0); bit != -1; bit = nextBit(&snapshot.misses, bit + 1)) {
+			hitmap->drawnCells[hitmap->drawnCount++] = bit;
+		}
+		for(int bit = nextBit(&snapshot.hits, 0); bit != -1; bit = nextBit(&snapshot.hits, bit + 1)) {
+			int x = bit % BITBOARD_STRIDE, y = bit / BITBOARD_STRIDE;
+			hitmap->drawnCells[hitmap->drawnCount++] = bit | HITMAP_DRAWN_HIT | (testBit(&snapshot.sunk, x, y) ? HITMAP_DRAWN_SUNK : 0);
 		}
 	}
+
+	SDL_Color sunkColor = {110, 110, 110, 255};
+	for(int i = 0; i < hitmap->drawnCount; i++) {
+		int bit = hitmap->drawnCells[i] & ~(HITMAP_DRAWN_HIT | HITMAP_DRAWN_SUNK);
+		enum SpriteEnum overlay = hitmap->drawnCells[i] & HITMAP_DRAWN_HIT ? HIT_OVERLAY_SPRITE : MISSED_OVERLAY_SPRITE;
+		SDL_Rect r = { .x = xOffset + (bit % BITBOARD_STRIDE) * squareWidth, .y = yOffset + (bit / BITBOARD_STRIDE) * squareHeight, .w = squareWidth, .h = squareHeight };
+		if(hitmap->drawnCells[i] & HITMAP_DRAWN_SUNK) renderSpriteMod(overlay, &r, 0, sunkColor);
+		else renderSprite(overlay, &r, 0);
+	}
+}
+
+// Returns the targeting density of the opponent's field, recomputing it only if the hitmap has changed.
+const DensityMap* updateTargetDensity() {
+	unsigned int version = atomic_load_explicit(&opponentHitmap->version, memory_order_acquire);
+	if(version != targetDensityVersion) {
+		HitmapBuffer snapshot;
+		const Ship* remaining[MAX_SHIPS];
+		targetDensityVersion = getHitmapSnapshot(opponentHitmap, &snapshot);
+		int remainingCount = getRemainingShips(&snapshot, shipDefinitions, numberOfShips, remaining);
+		computeDensityMap(&targetDensity, &snapshot, &gridMask, remaining, remainingCount);
+	}
+	return &targetDensity;
+}
+
+// Shades the opponent's cells by how likely they are to hold a ship, and highlights the best one.
+void drawTargetHint(const DensityMap* density, int xOffset, int yOffset) {
+	if(density->bestDensity == 0) return;
+	for(int bit = 0; bit < DENSITY_CELLS; bit++) {
+		if(density->cells[bit] == 0) continue;
+		unsigned char best = bit == getBitIndex(density->bestX, density->bestY);
+		SDL_Color shade = {255, best ? 255 : 160, 0, best ? 200 : 20 + 140 * density->cells[bit] / density->bestDensity};
+		SDL_Rect r = { .x = xOffset + (bit % BITBOARD_STRIDE) * squareWidth, .y = yOffset + (bit / BITBOARD_STRIDE) * squareHeight, .w = squareWidth, .h = squareHeight };
+		renderSpriteMod(MOUSE_OVERLAY_SPRITE, &r, 0, shade);
+	}
 }
 
 void handleAttack(int xOffset, int yOffset, int gridWidth, int gridHeight, char state) {
+	if(showTargetHint || autoPlay) {
+		const DensityMap* density = updateTargetDensity();
+		if(showTargetHint) drawTargetHint(density, xOffset, yOffset);
+		int targetX = density->bestX;
+		int targetY = density->bestY;
+		if(autoPlay && strategyState != NULL) { // The plugin decides; an invalid choice falls back to the density
+			HitmapBuffer snapshot;
+			unsigned char cells[BITBOARD_STRIDE * BITBOARD_MAX_SIZE];
+			int x, y;
+			getHitmapSnapshot(opponentHitmap, &snapshot);
+			getStrategyCells(cells, &snapshot, rows, cols);
+			strategyPlugin.strategy->chooseAttack(strategyState, cells, &x, &y);
+			if(validateAttack(&snapshot, &gridMask, x, y) == RULE_OK) {
+				targetX = x;
+				targetY = y;
+			}
+			else {
+				fprintf(stderr, "Warning: strategy %s chose an invalid attack on %d %d.\n", strategyPlugin.strategy->name, x, y);
+			}
+		}
+		if(autoPlay && targetX != -1) {
+			char msg[64];
+			sprintf(msg, AUTOPLAY_MSG, targetX + 65, targetY + 1);
+			setStatusBar(msg);
+			lockMutex(networkState.mutex);
+			networkState.clientInfo = 1;
+			networkState.x = targetX;
+			networkState.y = targetY;
+			signalClientInfo();
+			SDL_UnlockMutex(networkState.mutex);
+			return;
+		}
+	}
+
 	int mouseX;
 	int mouseY;
 	SDL_GetMouseState(&mouseX, &mouseY);
@@ -191,20 +371,23 @@ void handleAttack(int xOffset, int yOffset, int gridWidth, int gridHeight, char
 		int overlayX = mouseX - (mouseX % squareWidth);
 		int overlayY = mouseY - (mouseY % squareHeight);
 		SDL_Rect r = { .x = overlayX,.y = overlayY,.w = squareWidth,.h = squareHeight };
-		renderCopy(mouseOverlay, &r, 0);
+		renderSprite(MOUSE_OVERLAY_SPRITE, &r, 0);
 
 		int gridX, gridY;
 		convertMouseCoordsToGrid(mouseX, mouseY, xOffset, yOffset, &gridX, &gridY);
-		char msg[32];
-		sprintf(msg, ATTACK_ONGRID_MSG, gridX + 65, gridY + 1);
+		HitmapBuffer snapshot;
+		getHitmapSnapshot(opponentHitmap, &snapshot);
+		enum RuleResultEnum rule = validateAttack(&snapshot, &gridMask, gridX, gridY);
+		char msg[64];
+		sprintf(msg, rule == RULE_ALREADY_ATTACKED ? ATTACK_REPEATED_MSG : ATTACK_ONGRID_MSG, gridX + 65, gridY + 1);
 		setStatusBar(msg);
 
-		if(state & MOUSE_LEFT_PRESSED) {
+		if(rule == RULE_OK && state & MOUSE_LEFT_PRESSED) {
 			lockMutex(networkState.mutex);
 			networkState.clientInfo = 1;
 			networkState.x = gridX;
 			networkState.y = gridY;
-			SDL_CondSignal(networkState.clientSignal);
+			signalClientInfo();
 			SDL_UnlockMutex(networkState.mutex);
 		}
 	}
@@ -214,36 +397,44 @@ void handleAttack(int xOffset, int yOffset, int gridWidth, int gridHeight, char
 }
 
 void renderShip(Ship* ship, Uint8 alphaMod, int x, int y, int xOffset, int yOffset) {
-	for(int matrixY = 0; matrixY < 5; matrixY++) {
-		for(int matrixX = 0; matrixX < 5; matrixX++) {
-			if(ship->matrix[matrixY][matrixX] != 0) {
-				int partX = (x + matrixX) * squareWidth + xOffset;
-				int partY = (y + matrixY) * squareHeight + yOffset;
-				SDL_Rect r = { .x = partX,.y = partY,.w = squareWidth,.h = squareHeight };
-				SDL_Texture* t;
-				switch(ship->matrix[matrixY][matrixX]) {
-				case 'F':
-					t = shipFront;
-					break;
-				case 'M':
-					t = shipMiddle;
-					break;
-				case 'B':
-					t = shipBack;
-					break;
-				default:
-					printf("Error: %c is not a valid character for a ship part type.\n", ship->matrix[matrixY][matrixX]);
-					exit(1);
-				}
-				setTextureAlphaMod(t, alphaMod);
-				renderCopy(t, &r, ((double)ship->rotation) * 90);
-				setTextureAlphaMod(t, 255);
-			}
+	const ShipOrientation* orientation = getShipOrientation(ship);
+	SDL_Color c = {255, 255, 255, alphaMod};
+	for(int i = 0; i < orientation->partCount; i++) {
+		const ShipPart* part = &orientation->parts[i];
+		SDL_Rect r = { .x = (x + part->x) * squareWidth + xOffset,.y = (y + part->y) * squareHeight + yOffset,.w = squareWidth,.h = squareHeight };
+		enum SpriteEnum t;
+		switch(part->type) {
+		case 'F':
+			t = SHIP_FRONT_SPRITE;
+			break;
+		case 'M':
+			t = SHIP_MIDDLE_SPRITE;
+			break;
+		case 'B':
+			t = SHIP_BACK_SPRITE;
+			break;
+		default:
+			printf("Error: %c is not a valid character for a ship part type.\n", part->type);
+			exit(1);
 		}
+		renderSpriteMod(t, &r, orientation->angle, c);
 	}
 }
 
-// TODO: refactor this beast of a function
+// Selects the next ship that hasn't been placed yet.
+void nextShip() {
+	do {
+		currentShip = (currentShip + 1) % numberOfShips;
+	} while(globalShips[currentShip] == 0);
+}
+
+// Selects the previous ship that hasn't been placed yet.
+void previousShip() {
+	do {
+		currentShip = (numberOfShips + currentShip - 1) % numberOfShips;
+	} while(globalShips[currentShip] == 0);
+}
+
 unsigned char handleShipPlacement(int xOffset, int yOffset, int gridWidth, int gridHeight, char state) {
 	if(globalShips[currentShip] == NULL) return 0; // Ignore if ship doesn't exist (probably we're waiting for network thread right now)
 
@@ -252,91 +443,217 @@ unsigned char handleShipPlacement(int xOffset, int yOffset, int gridWidth, int g
 	int mouseY;
 	SDL_GetMouseState(&mouseX, &mouseY);
 
-	// Obtain ship edges coordinates and convert them to global pixel coordinates
-	int topEdge;
-	int bottomEdge;
-	int leftEdge;
-	int rightEdge;
-	getShipEdges(globalShips[currentShip], &topEdge , &bottomEdge, &leftEdge, &rightEdge);
-	topEdge = mouseY + (topEdge - 2) * squareHeight;
-	bottomEdge = mouseY + (bottomEdge - 2) * squareHeight;
-	leftEdge = mouseX + (leftEdge - 2) * squareWidth;
-	rightEdge = mouseX + (rightEdge - 2) * squareWidth;
-
-	if(leftEdge > xOffset && rightEdge < xOffset + gridWidth && topEdge > yOffset && bottomEdge < yOffset + gridHeight) { // If the ship overlay can fit within the grid
-
-		setStatusBar(PLACE_SHIPS_ONGRID_MSG);
-		// Calculate ship overlay x and y in grid and set them to ship
-		int shipX;
-		int shipY;
-		convertMouseCoordsToGrid(mouseX, mouseY, xOffset, yOffset, &shipX, &shipY);
-		globalShips[currentShip]->x = shipX - 2;
-		globalShips[currentShip]->y = shipY - 2;
-
-		if(state & MOUSE_RIGHT_PRESSED) // Rotate ship
-			changeShipRotation(globalShips[currentShip], 5);
-
-		if(state & MOUSE_LEFT_PRESSED) { // Place ship (if doesn't collide with other placed ships) & switch to next one
-			if(!checkCollisionWithPlacedShips(globalShips[currentShip])) {
-				for(int i = 0; i < NUMBER_OF_SHIPS; i++) {
-					if(ships[i] == 0) {
-						ships[i] = globalShips[currentShip];
-						globalShips[currentShip] = 0;
-						renderShip(ships[i], 255, ships[i]->x, ships[i]->y, xOffset, yOffset);
-
-						// Return 1 if all ships have been placed so the scene can update the client signal if necessary
-						unsigned char allPlaced = 1;
-						for(int i = 0; i < NUMBER_OF_SHIPS; i++) {
-							if(globalShips[i]) allPlaced = 0;
-						}
-						if(allPlaced) {
-							return 1;
-						}
-
-						// Otherwise go to next ship
-						nextShip();
-						return 0;
-					}
-				}
-			}
+	if(!(mouseX >= xOffset && mouseX < xOffset + gridWidth && mouseY >= yOffset && mouseY < yOffset + gridHeight)) {
+		char status[256];
+		sprintf(status, PLACE_SHIPS_MSG, opponentNickname);
+		setStatusBar(status);
+		return 0;
+	}
+
+	Ship* ship = globalShips[currentShip];
+	if(state & MOUSE_RIGHT_PRESSED) // Rotate ship
+		changeShipRotation(ship);
+
+	if(state & MOUSE_MIDDLE_PRESSED) { // Undo last placement
+		Ship* lastShip = removeLastShipFromFleet(&fleet);
+		if(lastShip != NULL) { // There is one or more ships placed
+			globalShips[lastShip->index] = lastShip;
 		}
+		previousShip();
+		return 0;
+	}
 
-		if(state & MOUSE_MIDDLE_PRESSED) { // Undo last placement
-			int lastShipI;
-			unsigned char done = 0;
-			for(int i = 0; i <= NUMBER_OF_SHIPS && !done; i++) {
-				if(i == NUMBER_OF_SHIPS || ships[i] == 0) {
-					lastShipI = i - 1;
-					done = 1;
-				}
-			}
-			if(lastShipI != -1) { // There is one or more ships placed
-				globalShips[ships[lastShipI]->index] = ships[lastShipI];
-				ships[lastShipI] = 0;
-			}
-			drawShipPlacementOverlay(globalShips[currentShip], xOffset, yOffset, gridWidth, gridHeight);
-			previousShip();
-			return 0;
+	if(state & MOUSE_WHEEL_DOWN) {
+		nextShip();
+		return 0;
+	}
+
+	if(state & MOUSE_WHEEL_UP) {
+		previousShip();
+		return 0;
+	}
+
+	// Legal positions only change when the ship, its orientation or the fleet do; hovering is a lookup in them
+	updatePlacementIndex(&placementIndex, &fleet, ship, &gridMask);
+	drawIllegalPlacementCells(&placementIndex, xOffset, yOffset);
+
+	// The mouse points at the center of the ship's matrix; if the ship can't go there, it snaps to the closest legal spot
+	const ShipOrientation* orientation = getShipOrientation(ship);
+	int mouseGridX;
+	int mouseGridY;
+	convertMouseCoordsToGrid(mouseX, mouseY, xOffset, yOffset, &mouseGridX, &mouseGridY);
+	int anchorX = mouseGridX - SHIP_MATRIX_SIZE / 2 + orientation->left;
+	int anchorY = mouseGridY - SHIP_MATRIX_SIZE / 2 + orientation->top;
+	if(!findNearestBit(&placementIndex.anchors, anchorX, anchorY, &anchorX, &anchorY)) {
+		setStatusBar(PLACE_SHIPS_NOWHERE_MSG);
+		return 0;
+	}
+	ship->x = anchorX - orientation->left;
+	ship->y = anchorY - orientation->top;
+	setStatusBar(PLACE_SHIPS_ONGRID_MSG);
+
+	if(state & MOUSE_LEFT_PRESSED) { // Place ship & switch to next one
+		addShipToFleet(&fleet, ship);
+		globalShips[currentShip] = 0;
+		renderShip(ship, 255, ship->x, ship->y, xOffset, yOffset);
+
+		// Return 1 if all ships have been placed so the scene can update the client signal if necessary
+		if(fleet.count == numberOfShips) {
+			return 1;
 		}
 
-		drawShipPlacementOverlay(globalShips[currentShip], xOffset, yOffset, gridWidth, gridHeight);
+		// Otherwise go to next ship
+		nextShip();
+		return 0;
+	}
+
+	drawShipPlacementOverlay(ship, xOffset, yOffset, gridWidth, gridHeight);
+	return 0;
+}
 
-		if(state & MOUSE_WHEEL_DOWN) {
-			nextShip();
-			return 0;
+typedef struct {
+	const FleetPlacer* placer;
+	uint64_t seed;
+	FleetLayout best;
+	int bestScore;
+	unsigned char found;
+} PlacementJob;
+
+// The optimized auto-place runs on worker threads while the placement scene keeps drawing frames.
+static struct {
+	FleetPlacer placer; // Read by the jobs, so only set up again once they are collected
+	PlacementJob jobs[MAX_PLACEMENT_THREADS];
+	SDL_Thread* threads[MAX_PLACEMENT_THREADS];
+	int jobCount;
+	atomic_int pending; // Jobs that haven't finished yet
+	unsigned char running;
+	Uint32 eventType; // Pushed by the last job to end, to wake up the game loop
+} fleetSearch;
+
+static int runPlacementJob(void* data) {
+	PlacementJob* job = data;
+	job->found = sampleBestFleet(job->placer, OPTIMIZED_PLACEMENT_CANDIDATES, &job->seed, &job->best, &job->bestScore);
+	if(atomic_fetch_sub(&fleetSearch.pending, 1) == 1) {
+		SDL_Event ev;
+		SDL_zero(ev);
+		ev.type = fleetSearch.eventType;
+		if(SDL_PushEvent(&ev) < 0) {
+			fprintf(stderr, "Error: couldn't push placement event:\n%s\n", SDL_GetError());
+			exit(1);
+		}
+	}
+	return 0;
+}
+
+// Starts sampling random fleets on every core, to find the one hunting bots should find last.
+static void startFleetSearch(uint64_t seed) {
+	if(fleetSearch.eventType == 0) {
+		fleetSearch.eventType = SDL_RegisterEvents(1);
+		if(fleetSearch.eventType == (Uint32) -1) {
+			fprintf(stderr, "Error: couldn't register placement event:\n%s\n", SDL_GetError());
+			exit(1);
 		}
+	}
+	int jobCount = SDL_GetCPUCount();
+	if(jobCount > MAX_PLACEMENT_THREADS) jobCount = MAX_PLACEMENT_THREADS;
+	fleetSearch.jobCount = jobCount;
+	atomic_store(&fleetSearch.pending, jobCount);
+	fleetSearch.running = 1;
+	for(int i = 0; i < jobCount; i++) {
+		PlacementJob* job = &fleetSearch.jobs[i];
+		job->placer = &fleetSearch.placer;
+		job->seed = nextRandom(&seed); // Seeds one step apart would give every job the same stream, shifted
+		fleetSearch.threads[i] = SDL_CreateThread(runPlacementJob, "placement", job);
+		if(fleetSearch.threads[i] == NULL) runPlacementJob(job);
+	}
+}
+
+unsigned char isFleetSearchRunning() {
+	return fleetSearch.running;
+}
 
-		if(state & MOUSE_WHEEL_UP) {
-			previousShip();
+// Waits for the optimized search to end and writes the best fleet it found to layout. Returns 0 if it found none.
+unsigned char collectFleetSearch(FleetLayout* layout) {
+	unsigned char found = 0;
+	int bestScore = 0;
+	for(int i = 0; i < fleetSearch.jobCount; i++) {
+		PlacementJob* job = &fleetSearch.jobs[i];
+		if(fleetSearch.threads[i] != NULL) SDL_WaitThread(fleetSearch.threads[i], NULL);
+		if(job->found && (!found || job->bestScore < bestScore)) {
+			*layout = job->best;
+			bestScore = job->bestScore;
+			found = 1;
+		}
+	}
+	fleetSearch.running = 0;
+	return found;
+}
+
+// Places the whole fleet at once, taking back the ships placed by hand first: at random, optimized against hunting
+// bots, or where the strategy plugin wants it. The optimized search takes a few frames, during which this must be
+// called again to finish it. Returns 1 if the fleet has been placed; if it can't be, sets autoPlaceFailed, which
+// stops autoplay from retrying on every frame.
+unsigned char autoPlaceFleet(enum AutoPlaceEnum mode) {
+	FleetLayout layout;
+	unsigned char found = 0;
+	uint64_t seed = SDL_GetPerformanceCounter();
+	if(fleetSearch.running) {
+		if(atomic_load(&fleetSearch.pending) > 0) {
+			setStatusBar(AUTO_PLACE_BUSY_MSG);
 			return 0;
 		}
+		found = collectFleetSearch(&layout);
+		if(!found) fprintf(stderr, "Warning: the optimized search found no fleet, placing it at random.\n");
+		mode = AUTO_PLACE_RANDOM;
 	}
 	else {
-		char status[256];
-		sprintf(status, PLACE_SHIPS_MSG, opponentNickname);
-		setStatusBar(status);
+		Ship* lastShip;
+		while((lastShip = removeLastShipFromFleet(&fleet)) != NULL) globalShips[lastShip->index] = lastShip;
+		currentShip = 0;
+		if(!initFleetPlacer(&fleetSearch.placer, globalShips, numberOfShips, &gridMask)) mode = AUTO_PLACE_NONE;
+
+		if(mode == AUTO_PLACE_STRATEGY) {
+			StrategyPlacement placements[MAX_SHIPS];
+			found = strategyPlugin.strategy->placeFleet(strategyState, placements)
+				&& getStrategyFleetLayout(placements, globalShips, numberOfShips, &gridMask, &layout);
+			if(!found) {
+				fprintf(stderr, "Warning: strategy %s didn't place a valid fleet, placing it at random.\n", strategyPlugin.strategy->name);
+				mode = AUTO_PLACE_RANDOM;
+			}
+		}
+		if(mode == AUTO_PLACE_OPTIMIZED) {
+			startFleetSearch(seed);
+			setStatusBar(AUTO_PLACE_BUSY_MSG);
+			return 0;
+		}
+	}
+	if(!found && mode == AUTO_PLACE_RANDOM) found = sampleRandomFleet(&fleetSearch.placer, &layout, &seed);
+	if(!found) {
+		fprintf(stderr, "Error: couldn't place the fleet automatically, some ship doesn't fit in the grid.\n");
+		setStatusBar(AUTO_PLACE_FAILED_MSG);
+		autoPlaceFailed = 1;
+		return 0;
+	}
+
+	autoPlaceFailed = 0;
+	Ship* ships[MAX_SHIPS];
+	for(int i = 0; i < numberOfShips; i++) {
+		ships[i] = globalShips[i];
+		globalShips[i] = 0;
+	}
+	applyFleetLayout(&layout, ships, numberOfShips, &fleet);
+	return 1;
+}
+
+// Shades the cells the current ship can't be centered on.
+void drawIllegalPlacementCells(const PlacementIndex* index, int xOffset, int yOffset) {
+	Bitboard illegal = gridMask;
+	andNotBitboard(&illegal, &index->centers);
+	SDL_Color shade = {255, 60, 60, 90};
+	for(int bit = nextBit(&illegal, 0); bit != -1; bit = nextBit(&illegal, bit + 1)) {
+		SDL_Rect r = { .x = xOffset + (bit % BITBOARD_STRIDE) * squareWidth, .y = yOffset + (bit / BITBOARD_STRIDE) * squareHeight, .w = squareWidth, .h = squareHeight };
+		renderSpriteMod(MOUSE_OVERLAY_SPRITE, &r, 0, shade);
 	}
-	return 0;
 }
 
 void drawShipPlacementOverlay(Ship* ship, int xOffset, int yOffset, int gridWidth, int gridHeight) {
@@ -344,18 +661,7 @@ void drawShipPlacementOverlay(Ship* ship, int xOffset, int yOffset, int gridWidt
 }
 
 void drawPlacedShips(int xOffset, int yOffset) {
-	for(int i = 0; i < NUMBER_OF_SHIPS && ships[i] != 0; i++) {
-		renderShip(ships[i], 255, ships[i]->x, ships[i]->y, xOffset, yOffset);
+	for(int i = 0; i < fleet.count; i++) {
+		renderShip(fleet.ships[i], 255, fleet.ships[i]->x, fleet.ships[i]->y, xOffset, yOffset);
 	}
 }
-
-Ship* checkCollisionWithPlacedShips(Ship* ship) {
-	for(int i = 0; i < NUMBER_OF_SHIPS; i++) {
-		if(ships[i] != 0) {
-			if(checkShipCollision(ship, ships[i])) {
-				return ships[i];
-			}
-		}
-	}
-	return 0;
-}
\ No newline at end of file
@@ -1,42 +1,48 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_net.h>
 #include <SDL2/SDL_ttf.h>
 #include "globals.h"
 
 char* nickname;
 SDL_Window* window;
 SDL_Renderer* renderer;
-SDL_Texture* gridSquareA;
-SDL_Texture* gridSquareB;
-SDL_Texture* mouseOverlay;
-SDL_Texture* shipFront;
-SDL_Texture* shipMiddle;
-SDL_Texture* shipBack;
-SDL_Texture* hitOverlay;
-SDL_Texture* missedOverlay;
-Ship* destroyer;
-Ship* submarine;
-Ship* cruiser;
-Ship* battleship;
-Ship* carrier;
-Ship* globalShips[NUMBER_OF_SHIPS];
-Ship* ships[NUMBER_OF_SHIPS];
+SDL_Texture* spriteAtlas;
+SDL_Rect sprites[NUMBER_OF_SPRITES];
+char* fleetPath;
+int numberOfShips;
+Ship* shipDefinitions[MAX_SHIPS];
+Ship* globalShips[MAX_SHIPS];
+Arena matchArena;
+Fleet fleet;
+PlacementIndex placementIndex;
 TTF_Font* mainFont;
-SDL_Texture** gridColLabels;
-SDL_Texture** gridRowLabels;
+SDL_Texture* boardLayer;
+int boardLayerSquareWidth;
+int boardLayerSquareHeight;
+int boardLayerCols;
+int boardLayerRows;
 int screenWidth;
 int screenHeight;
 int squareWidth;
 int squareHeight;
 int cols;
 int rows;
+Bitboard gridMask;
 unsigned char currentShip;
 unsigned char currentScene;
 SDL_Thread* networkThread;
 char* serverAddress;
 long int serverPort;
-TCPsocket serverSocket;
-SDLNet_SocketSet socketSet;
 char opponentNickname[64];
 Hitmap* ownHitmap;
-Hitmap* opponentHitmap;
\ No newline at end of file
+Hitmap* opponentHitmap;
+DensityMap targetDensity;
+unsigned int targetDensityVersion;
+unsigned char showTargetHint;
+unsigned char autoPlay;
+enum AutoPlaceEnum autoPlaceRequest;
+unsigned char autoPlaceFailed;
+char* strategyPath;
+StrategyPlugin strategyPlugin;
+StrategyShip strategyShips[MAX_SHIPS];
+StrategyGame strategyGame;
+void* strategyState;
\ No newline at end of file
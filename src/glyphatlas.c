@@ -0,0 +1,116 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "globals.h"
+#include "glyphatlas.h"
+#include "batch.h"
+#include "load.h"
+#include "memstats.h"
+
+GlyphAtlas glyphAtlas;
+
+// Pre-rasterizes the printable glyph set of font, in white, into a single texture.
+// Text is then drawn by tinting quads taken from it, with no TTF work at runtime.
+void loadGlyphAtlas(TTF_Font* font) {
+	SDL_Color white = {255, 255, 255, 255};
+	SDL_Surface* glyphSurfaces[GLYPH_ATLAS_COUNT];
+
+	// Render every glyph and lay them out in rows, leaving a pixel of padding around each
+	glyphAtlas.lineHeight = TTF_FontHeight(font);
+	int penX = 1, penY = 1;
+	for(int i = 0; i < GLYPH_ATLAS_COUNT; i++) {
+		Uint16 ch = (Uint16) (GLYPH_ATLAS_FIRST + i);
+		int advance = 0;
+		glyphSurfaces[i] = NULL;
+		if(TTF_GlyphIsProvided(font, ch)) {
+			glyphSurfaces[i] = TTF_RenderGlyph_Blended(font, ch, white);
+			if(TTF_GlyphMetrics(font, ch, NULL, NULL, NULL, NULL, &advance) < 0) advance = 0;
+		}
+		int glyphWidth = glyphSurfaces[i] != NULL ? glyphSurfaces[i]->w : advance;
+
+		if(penX + glyphWidth + 1 > GLYPH_ATLAS_WIDTH) {
+			penX = 1;
+			penY += glyphAtlas.lineHeight + 1;
+		}
+		SDL_Rect r = { .x = penX, .y = penY, .w = glyphWidth, .h = glyphAtlas.lineHeight };
+		glyphAtlas.glyphs[i] = r;
+		penX += glyphWidth + 1;
+	}
+	glyphAtlas.width = GLYPH_ATLAS_WIDTH;
+	glyphAtlas.height = penY + glyphAtlas.lineHeight + 1;
+
+	SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, glyphAtlas.width, glyphAtlas.height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if(atlas == NULL) {
+		printf("Error: couldn't create glyph atlas surface:\n%s", SDL_GetError());
+		exit(1);
+	}
+	for(int i = 0; i < GLYPH_ATLAS_COUNT; i++) {
+		if(glyphSurfaces[i] == NULL) continue;
+		SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE); // Copy alpha as it is
+		SDL_Rect r = glyphAtlas.glyphs[i];
+		if(SDL_BlitSurface(glyphSurfaces[i], NULL, atlas, &r) < 0) {
+			printf("Error: couldn't copy glyph into atlas:\n%s", SDL_GetError());
+			exit(1);
+		}
+		SDL_FreeSurface(glyphSurfaces[i]);
+	}
+
+	glyphAtlas.texture = SDL_CreateTextureFromSurface(renderer, atlas);
+	if(glyphAtlas.texture == NULL) {
+		printf("Error: couldn't convert glyph atlas to texture:\n%s", SDL_GetError());
+		exit(1);
+	}
+	trackTexture(MEM_TEXT, glyphAtlas.texture);
+	SDL_SetTextureBlendMode(glyphAtlas.texture, SDL_BLENDMODE_BLEND);
+	SDL_FreeSurface(atlas);
+}
+
+// Returns 1 if every character of text is in the atlas.
+unsigned char canDrawText(const char* text) {
+	for(const unsigned char* c = (const unsigned char*) text; *c; c++) {
+		if(*c < GLYPH_ATLAS_FIRST || *c > GLYPH_ATLAS_LAST) return 0;
+	}
+	return 1;
+}
+
+// Gets the atlas cell of a character; characters outside of the atlas are shown as '?'.
+static SDL_Rect* getGlyph(char c) {
+	unsigned char ch = (unsigned char) c;
+	if(ch < GLYPH_ATLAS_FIRST || ch > GLYPH_ATLAS_LAST) ch = '?';
+	return &glyphAtlas.glyphs[ch - GLYPH_ATLAS_FIRST];
+}
+
+// Gets the size of text when drawn at the font's own size.
+void measureText(const char* text, int* width, int* height) {
+	int w = 0;
+	for(const char* c = text; *c; c++) {
+		w += getGlyph(*c)->w;
+	}
+	if(width != NULL) *width = w;
+	if(height != NULL) *height = glyphAtlas.lineHeight;
+}
+
+// Draws text stretched to fill dstrect, tinted with color.
+// Glyphs are queued on the sprite batch, so a whole string is submitted with a single call.
+void drawText(const char* text, SDL_Rect* dstrect, SDL_Color color) {
+	int textWidth, textHeight;
+	measureText(text, &textWidth, &textHeight);
+	if(textWidth == 0 || textHeight == 0) return;
+	float scaleX = (float) dstrect->w / textWidth;
+
+	SDL_FRect r = { .x = (float) dstrect->x, .y = (float) dstrect->y, .w = 0, .h = (float) dstrect->h };
+	for(const char* c = text; *c; c++) {
+		SDL_Rect* g = getGlyph(*c);
+		r.w = g->w * scaleX;
+		batchQuad(glyphAtlas.texture, g, &r, 0, color);
+		r.x += r.w;
+	}
+}
+
+void destroyGlyphAtlas() {
+	if(glyphAtlas.texture != NULL) {
+		destroyTrackedTexture(MEM_TEXT, glyphAtlas.texture);
+		glyphAtlas.texture = NULL;
+	}
+}
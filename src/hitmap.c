@@ -0,0 +1,70 @@
+#include <string.h>
+#include "hitmap.h"
+
+Hitmap* initHitmap(Arena* arena) {
+	Hitmap* hitmap = arenaAlloc(arena, sizeof(Hitmap), MEM_HITMAPS);
+	memset(hitmap->buffers, 0, sizeof(hitmap->buffers));
+	atomic_init(&hitmap->version, 0);
+	hitmap->drawnVersion = 1; // Published versions are even, so the first snapshot is always drawn
+	hitmap->drawnCount = 0;
+	return hitmap;
+}
+
+// Publishes an empty hitmap. Like setHitmapField, it must not race with another writer.
+void resetHitmap(Hitmap* hitmap) {
+	unsigned int version = atomic_load_explicit(&hitmap->version, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	HitmapBuffer* back = &hitmap->buffers[(version / 2 + 1) % 2];
+	clearBitboard(&back->misses);
+	clearBitboard(&back->hits);
+	clearBitboard(&back->sunk);
+	atomic_store_explicit(&hitmap->version, version + 2, memory_order_release);
+}
+
+// Sets a field of the hitmap and publishes the change: 0 clears it, 1 marks a miss, 2 a hit.
+// Only the network thread writes hitmaps, so the back buffer is never written concurrently.
+void setHitmapField(Hitmap* hitmap, int x, int y, char value) {
+	unsigned int version = atomic_load_explicit(&hitmap->version, memory_order_relaxed);
+	// Readers that still copy the back buffer (published two versions ago) must see a newer version before our writes
+	atomic_thread_fence(memory_order_release);
+	HitmapBuffer* front = &hitmap->buffers[(version / 2) % 2];
+	HitmapBuffer* back = &hitmap->buffers[(version / 2 + 1) % 2];
+	*back = *front;
+	clearBit(&back->misses, x, y);
+	clearBit(&back->hits, x, y);
+	if(value == 1) setBit(&back->misses, x, y);
+	else if(value == 2) setBit(&back->hits, x, y);
+	atomic_store_explicit(&hitmap->version, version + 2, memory_order_release);
+}
+
+// Marks cells as belonging to a sunk ship and publishes the change. Same single writer rule as setHitmapField.
+void markHitmapSunk(Hitmap* hitmap, const Bitboard* cells) {
+	unsigned int version = atomic_load_explicit(&hitmap->version, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	HitmapBuffer* front = &hitmap->buffers[(version / 2) % 2];
+	HitmapBuffer* back = &hitmap->buffers[(version / 2 + 1) % 2];
+	*back = *front;
+	orBitboard(&back->sunk, cells);
+	andBitboard(&back->sunk, &back->hits);
+	atomic_store_explicit(&hitmap->version, version + 2, memory_order_release);
+}
+
+char getHitmapField(Hitmap* hitmap, int x, int y) {
+	HitmapBuffer snapshot;
+	getHitmapSnapshot(hitmap, &snapshot);
+	return testBit(&snapshot.hits, x, y) ? 2 : testBit(&snapshot.misses, x, y);
+}
+
+// Copies the published buffer into snapshot and returns its version, without locking.
+// Retries if an update was published while copying, since the next one reuses the buffer being copied.
+unsigned int getHitmapSnapshot(Hitmap* hitmap, HitmapBuffer* snapshot) {
+	unsigned int version;
+	unsigned int check;
+	do {
+		version = atomic_load_explicit(&hitmap->version, memory_order_acquire);
+		*snapshot = hitmap->buffers[(version / 2) % 2];
+		atomic_thread_fence(memory_order_acquire);
+		check = atomic_load_explicit(&hitmap->version, memory_order_relaxed);
+	} while(version != check);
+	return version;
+}
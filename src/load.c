@@ -7,39 +7,28 @@
 #include "ship.h"
 #include "network.h"
 #include "load.h"
-
-// strtok_r is widely used in the program but not defined in mingw
-#if defined(__MINGW32__) || defined(__MINGW64__)
-char* strtok_r(char *str, const char *delim, char **nextp) {
-    char *ret;
-    if (str == NULL) {
-        str = *nextp;
-    }
-    str += strspn(str, delim);
-    if (*str == '\0') {
-        return NULL;
-    }
-    ret = str;
-    str += strcspn(str, delim);
-    if (*str) {
-        *str++ = '\0';
-    }
-    *nextp = str;
-    return ret;
-}
-#endif
+#include "batch.h"
+#include "textcache.h"
+#include "glyphatlas.h"
+#include "game.h"
+#include "fleetfile.h"
 
 void init() {
 	if(SDL_Init(SDL_INIT_VIDEO) < 0) {
 		printf("Error: couldn't initialize SDL:\n%s", SDL_GetError());
 		exit(1);
 	}
-	initNetwork();
 	if(TTF_Init() < 0) {
 		printf("Error: couldn't initialize SDL_ttf:\n%s", TTF_GetError());
 		exit(1);
 	}
 
+	if(rows > BITBOARD_MAX_SIZE || cols > BITBOARD_MAX_SIZE) {
+		printf("Error: the grid can be at most %dx%d.\n", BITBOARD_MAX_SIZE, BITBOARD_MAX_SIZE);
+		exit(1);
+	}
+	makeBoardMask(&gridMask, rows, cols);
+
 	screenWidth = squareWidth * (2 * cols + 2);
 	screenHeight = squareHeight * (rows + 1) + 50;
 
@@ -48,61 +37,125 @@ void init() {
 		printf("Error: couldn't create SDL window:\n%s", SDL_GetError());
 		exit(1);
 	}
-	renderer = SDL_CreateRenderer(window, -1, 0);
+	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
 	if(renderer == NULL) {
 		printf("Error: couldn't create SDL renderer:\n%s", SDL_GetError());
 		exit(1);
 	}
 	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
 
-	gridSquareA = loadTexture("resources/grid_square_a.bmp", NULL, NULL);
-	gridSquareB = loadTexture("resources/grid_square_b.bmp", NULL, NULL);
-	mouseOverlay = loadTexture("resources/mouse_overlay.bmp", NULL, NULL);
-	shipFront = loadTexture("resources/ship_front.bmp", NULL, NULL);
-	shipMiddle = loadTexture("resources/ship_middle.bmp", NULL, NULL);
-	shipBack = loadTexture("resources/ship_back.bmp", NULL, NULL);
-	hitOverlay = loadTexture("resources/hit_overlay.bmp", NULL, NULL);
-	missedOverlay = loadTexture("resources/missed_overlay.bmp", NULL, NULL);
+	loadSpriteAtlas();
 
 	mainFont = loadFont("resources/november.ttf", 30);
-	loadGridCoordLabels();
-	loadShips();
-	ownHitmap = initHitmap();
-	opponentHitmap = initHitmap();
-	memset(ships, 0, sizeof ships);
-	currentShip = 0;
+	loadGlyphAtlas(mainFont);
+	numberOfShips = loadFleetFile(fleetPath, shipDefinitions);
+	if(strategyPath != NULL) {
+		loadStrategyPlugin(&strategyPlugin, strategyPath);
+		describeStrategyGame(&strategyGame, strategyShips, shipDefinitions, numberOfShips, rows, cols);
+		autoPlay = 1;
+		printf("Playing with strategy %s from %s\n", strategyPlugin.strategy->name, strategyPath);
+	}
+	initArena(&matchArena, MATCH_ARENA_SIZE);
+	startMatch();
+
+	// Started last: resolving and connecting happen on the network thread while the connecting scene is shown
+	initNetwork();
 }
 
-SDL_Texture* loadTexture(const char* path, int* width, int* height) {
-	SDL_Surface* surface = SDL_LoadBMP(path);
-	if(surface == NULL) {
-		printf("Error: couldn't load texture %s:\n%s", path, SDL_GetError());
+// Loads the sprite of every SpriteEnum value, in the same order
+const char* spritePaths[NUMBER_OF_SPRITES] = {
+	"resources/grid_square_a.bmp",
+	"resources/grid_square_b.bmp",
+	"resources/mouse_overlay.bmp",
+	"resources/ship_front.bmp",
+	"resources/ship_middle.bmp",
+	"resources/ship_back.bmp",
+	"resources/hit_overlay.bmp",
+	"resources/missed_overlay.bmp"
+};
+
+// Packs every sprite into a single texture, spriteAtlas, and writes where each one ended up in sprites.
+// Sprites are placed on shelves from the tallest to the shortest, with a pixel of padding around them,
+// so that drawing a whole board never needs to switch texture.
+void loadSpriteAtlas() {
+	SDL_Surface* surfaces[NUMBER_OF_SPRITES];
+	int order[NUMBER_OF_SPRITES];
+	for(int i = 0; i < NUMBER_OF_SPRITES; i++) {
+		surfaces[i] = SDL_LoadBMP(spritePaths[i]);
+		if(surfaces[i] == NULL) {
+			printf("Error: couldn't load texture %s:\n%s", spritePaths[i], SDL_GetError());
+			exit(1);
+		}
+		// Insertion sort by decreasing height
+		int j = i;
+		while(j > 0 && surfaces[order[j - 1]]->h < surfaces[i]->h) {
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = i;
+	}
+
+	int penX = 1, penY = 1, shelfHeight = 0, atlasWidth = 0;
+	for(int k = 0; k < NUMBER_OF_SPRITES; k++) {
+		SDL_Surface* surface = surfaces[order[k]];
+		if(penX > 1 && penX + surface->w + 1 > SPRITE_ATLAS_MAX_WIDTH) { // Start a new shelf
+			penX = 1;
+			penY += shelfHeight + 1;
+			shelfHeight = 0;
+		}
+		SDL_Rect r = { .x = penX, .y = penY, .w = surface->w, .h = surface->h };
+		sprites[order[k]] = r;
+		penX += surface->w + 1;
+		if(surface->h > shelfHeight) shelfHeight = surface->h;
+		if(penX > atlasWidth) atlasWidth = penX;
+	}
+
+	SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, penY + shelfHeight + 1, 32, SDL_PIXELFORMAT_ARGB8888);
+	if(atlas == NULL) {
+		printf("Error: couldn't create sprite atlas surface:\n%s", SDL_GetError());
 		exit(1);
 	}
-	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-	if(texture == NULL) {
+	for(int i = 0; i < NUMBER_OF_SPRITES; i++) {
+		SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE); // Copy alpha as it is; opaque sprites get full alpha
+		if(SDL_BlitSurface(surfaces[i], NULL, atlas, &sprites[i]) < 0) {
+			printf("Error: couldn't copy %s into the sprite atlas:\n%s", spritePaths[i], SDL_GetError());
+			exit(1);
+		}
+		SDL_FreeSurface(surfaces[i]);
+	}
+
+	spriteAtlas = SDL_CreateTextureFromSurface(renderer, atlas);
+	if(spriteAtlas == NULL) {
 		printf("Error: couldn't convert surface to texture:\n%s", SDL_GetError());
 		exit(1);
 	}
-	SDL_FreeSurface(surface);
-	if(width != NULL && height != NULL) {
-		SDL_QueryTexture(texture, NULL, NULL, width, height);
-	}
-	return texture;
+	trackTexture(MEM_ASSETS, spriteAtlas);
+	SDL_SetTextureBlendMode(spriteAtlas, SDL_BLENDMODE_BLEND);
+	SDL_FreeSurface(atlas);
+}
+
+// Draws a sprite from the atlas at dstrect rotated by angle degrees.
+void renderSprite(enum SpriteEnum sprite, SDL_Rect* dstrect, double angle) {
+	SDL_Color c = {255, 255, 255, 255};
+	renderSpriteMod(sprite, dstrect, angle, c);
 }
 
+// Like renderSprite, but modulates the sprite with color (alpha included).
+void renderSpriteMod(enum SpriteEnum sprite, SDL_Rect* dstrect, double angle, SDL_Color color) {
+	SDL_FRect r = { .x = (float) dstrect->x, .y = (float) dstrect->y, .w = (float) dstrect->w, .h = (float) dstrect->h };
+	batchQuad(spriteAtlas, &sprites[sprite], &r, angle, color);
+}
+
+// Draws texture at dstrect rotated by angle degrees. Goes through the sprite batch, like every other draw.
 void renderCopy(SDL_Texture* texture, SDL_Rect* dstrect, double angle) {
-	if(SDL_RenderCopyEx(renderer, texture, NULL, dstrect, angle, NULL, SDL_FLIP_NONE) < 0) {
-		printf("Error: couldn't copy texture to window:\n%s", SDL_GetError());
-		exit(1);
-	}
+	SDL_Color c = {255, 255, 255, 255};
+	renderCopyMod(texture, dstrect, angle, c);
 }
 
-void setTextureAlphaMod(SDL_Texture* texture, Uint8 alphaMod) {
-	if(SDL_SetTextureAlphaMod(texture, alphaMod) < 0) {
-		printf("Error: couldn't set alpha mod on texture:\n%s", SDL_GetError());
-		exit(1);
-	}
+// Like renderCopy, but modulates the texture with color (alpha included).
+void renderCopyMod(SDL_Texture* texture, SDL_Rect* dstrect, double angle, SDL_Color color) {
+	SDL_FRect r = { .x = (float) dstrect->x, .y = (float) dstrect->y, .w = (float) dstrect->w, .h = (float) dstrect->h };
+	batchQuad(texture, NULL, &r, angle, color);
 }
 
 TTF_Font* loadFont(const char* path, int ptsize) {
@@ -126,169 +179,94 @@ SDL_Texture* getFontTexture(TTF_Font* font, const char* text, SDL_Color fgColor)
 		exit(1);
 	}
 	SDL_FreeSurface(surface);
+	trackTexture(MEM_TEXT, texture);
 	return texture;
 }
 
-void loadGridCoordLabels() {
-	size_t gridColLabelsSize = 2 * (size_t)cols * sizeof(SDL_Texture*);
-	if(gridColLabelsSize < 16) gridColLabelsSize = 16; // Must be at least 16 to avoid buffer overflow when writing
-	size_t gridRowLabelsSize = 2 * (size_t)rows * sizeof(SDL_Texture*);
-	if(gridRowLabelsSize < 16) gridRowLabelsSize = 16;
-	gridColLabels = malloc(gridColLabelsSize);
-	if(gridColLabels == NULL) {
-		printf("Error: couldn't allocate memory (%zu bytes) for column coordinate labels.\n", gridColLabelsSize);
-		exit(1);
-	}
-	gridRowLabels = malloc(gridRowLabelsSize);
-	if(gridRowLabels == NULL) {
-		printf("Error: couldn't allocate memory (%zu bytes) for row coordinate labels.\n", gridRowLabelsSize);
-		exit(1);
-	}
-	// Write all column labels
-	for(int set = 0; set < 2; set++) {
-		for(int n = 0; n < cols; n++) {
-			char label[3];
-			label[0] = 65 + n;
-			label[1] = '\0';
-			SDL_Color c;
-			if(set == 0) {
-				c.r = 0;
-				c.g = 255;
-				c.b = 217;
-				c.a = 255;
-			}
-			else {
-				c.r = 255;
-				c.g = 136;
-				c.b = 0;
-				c.a = 255;
-			}
-			gridColLabels[set * cols + n] = getFontTexture(mainFont, label, c);
-		}
-	}
-	// Write all row labels
-	for(int set = 0; set < 2; set++) {
-		for(int n = 0; n < rows; n++) {
-			char label[3];
-			snprintf(label, sizeof(label), "%d", n + 1);
-			SDL_Color c;
-			if(set == 0) {
-				c.r = 0;
-				c.g = 255;
-				c.b = 217;
-				c.a = 255;
-			}
-			else {
-				c.r = 255;
-				c.g = 136;
-				c.b = 0;
-				c.a = 255;
-			}
-			gridRowLabels[set * rows + n] = getFontTexture(mainFont, label, c);
-		}
-	}
+// Returns an estimate of the memory texture takes, counting 4 bytes per pixel whatever its format.
+static size_t getTextureSize(SDL_Texture* texture) {
+	int width, height;
+	if(SDL_QueryTexture(texture, NULL, NULL, &width, &height) < 0) return 0;
+	return (size_t) width * height * 4;
 }
 
-char** allocateAndZeroMatrix(int sizeY, int sizeX) {
-	size_t byteSizeY = sizeY * sizeof(char*);
-	size_t byteSizeX = sizeX * sizeof(char);
-	if(byteSizeY < 16) byteSizeY = 16;
-	if(byteSizeX < 16) byteSizeX = 16;
-	char** matrix = malloc(byteSizeY);
-	if(matrix == NULL) {
-		printf("Error: couldn't allocate memory for matrix.\n");
-		exit(1);
-	}
-	for(int y = 0; y < sizeY; y++) {
-		matrix[y] = malloc(byteSizeX);
-		if(matrix[y] == NULL) {
-			printf("Error: couldn't allocate memory for row of a matrix.\n");
-			exit(1);
-		}
-		for(int x = 0; x < sizeX; x++) {
-			matrix[y][x] = 0;
-		}
-	}
-	return matrix;
+// Accounts a texture that has just been created to tag.
+void trackTexture(enum MemTagEnum tag, SDL_Texture* texture) {
+	recordAllocation(tag, getTextureSize(texture));
 }
 
-void copyMatrix(char** dst, char** src, int sizeY, int sizeX) {
-	for(int y = 0; y < sizeY; y++) {
-		memcpy(dst[y], src[y], sizeX * sizeof(char));
-	}
+void destroyTrackedTexture(enum MemTagEnum tag, SDL_Texture* texture) {
+	recordRelease(tag, getTextureSize(texture), 1);
+	SDL_DestroyTexture(texture);
 }
 
-void freeMatrix(char** matrix, int sizeY, int sizeX) {
-	for(int y = 0; y < sizeY; y++) {
-		free(matrix[y]);
+// Allocates the state of a new match from the match arena: the ships to place, copied from their definitions, and
+// both hitmaps. The network thread's request buffer is drawn from the same arena.
+void startMatch() {
+	resetArena(&matchArena);
+	for(int i = 0; i < numberOfShips; i++) {
+		globalShips[i] = arenaAlloc(&matchArena, sizeof(Ship), MEM_SHIPS);
+		*globalShips[i] = *shipDefinitions[i];
+	}
+	ownHitmap = initHitmap(&matchArena);
+	opponentHitmap = initHitmap(&matchArena);
+	targetDensityVersion = 1; // Published hitmap versions are even, so the density is computed on the first turn
+	clearFleet(&fleet);
+	invalidatePlacementIndex(&placementIndex);
+	currentShip = 0;
+	if(strategyPlugin.strategy != NULL) {
+		strategyState = strategyPlugin.strategy->create(&strategyGame, SDL_GetPerformanceCounter());
+		if(strategyState == NULL) {
+			fprintf(stderr, "Error: strategy %s couldn't start a match.\n", strategyPlugin.strategy->name);
+			exit(1);
+		}
 	}
-	free(matrix);
-}
-
-void loadShips() {
-	destroyer = makeShip("destroyer", 0, 5, 5);
-	submarine = makeShip("submarine", 1, 5, 5);
-	cruiser = makeShip("cruiser", 2, 5, 5);
-	battleship = makeShip("battleship", 3, 5, 5);
-	carrier = makeShip("carrier", 4, 5, 5);
-
-	memcpy(destroyer->matrix[0], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-	memcpy(destroyer->matrix[1], (char[5]) { 0, 0, 'F', 0, 0 }, 5 * sizeof(char));
-	memcpy(destroyer->matrix[2], (char[5]) { 0, 0, 'B', 0, 0 }, 5 * sizeof(char));
-	memcpy(destroyer->matrix[3], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-	memcpy(destroyer->matrix[4], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-
-	memcpy(submarine->matrix[0], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-	memcpy(submarine->matrix[1], (char[5]) { 0, 0, 'F', 0, 0 }, 5 * sizeof(char));
-	memcpy(submarine->matrix[2], (char[5]) { 0, 0, 'M', 0, 0 }, 5 * sizeof(char));
-	memcpy(submarine->matrix[3], (char[5]) { 0, 0, 'B', 0, 0 }, 5 * sizeof(char));
-	memcpy(submarine->matrix[4], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-
-	memcpy(cruiser->matrix[0], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-	memcpy(cruiser->matrix[1], (char[5]) { 0, 0, 'F', 0, 0 }, 5 * sizeof(char));
-	memcpy(cruiser->matrix[2], (char[5]) { 0, 0, 'M', 0, 0 }, 5 * sizeof(char));
-	memcpy(cruiser->matrix[3], (char[5]) { 0, 0, 'B', 0, 0 }, 5 * sizeof(char));
-	memcpy(cruiser->matrix[4], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-
-	memcpy(battleship->matrix[0], (char[5]) { 0, 0, 'F', 0, 0 }, 5 * sizeof(char));
-	memcpy(battleship->matrix[1], (char[5]) { 0, 0, 'M', 0, 0 }, 5 * sizeof(char));
-	memcpy(battleship->matrix[2], (char[5]) { 0, 0, 'M', 0, 0 }, 5 * sizeof(char));
-	memcpy(battleship->matrix[3], (char[5]) { 0, 0, 'B', 0, 0 }, 5 * sizeof(char));
-	memcpy(battleship->matrix[4], (char[5]) { 0, 0, 0, 0, 0 }, 5 * sizeof(char));
-
-	memcpy(carrier->matrix[0], (char[5]){ 0, 0, 'F', 0, 0 }, 5 * sizeof(char));
-	memcpy(carrier->matrix[1], (char[5]){ 0, 0, 'M', 0, 0 }, 5 * sizeof(char));
-	memcpy(carrier->matrix[2], (char[5]){ 0, 0, 'M', 0, 0 }, 5 * sizeof(char));
-	memcpy(carrier->matrix[3], (char[5]){ 0, 0, 'M', 0, 0 }, 5 * sizeof(char));
-	memcpy(carrier->matrix[4], (char[5]){ 0, 0, 'B', 0, 0 }, 5 * sizeof(char));
-
-	globalShips[0] = destroyer;
-	globalShips[1] = submarine;
-	globalShips[2] = cruiser;
-	globalShips[3] = battleship;
-	globalShips[4] = carrier;
 }
 
-Hitmap* initHitmap() {
-	Hitmap* hitmap = malloc(sizeof(Hitmap));
-	hitmap->mutex = SDL_CreateMutex();
-	if(hitmap->mutex == NULL) {
-		fprintf(stderr, "Error: couldn't make mutex for hitmap:\n%s\n", SDL_GetError());
-		exit(1);
+// Releases the state of the match in one go, once the network thread is done with it.
+void endMatch() {
+	if(networkThread != NULL) {
+		SDL_WaitThread(networkThread, NULL);
+		networkThread = NULL;
 	}
-	hitmap->map = allocateAndZeroMatrix(rows, cols);
-	return hitmap;
+	if(strategyState != NULL) {
+		strategyPlugin.strategy->destroy(strategyState);
+		strategyState = NULL;
+	}
+	printf("Match used %zu of %zu bytes of its arena.\n", matchArena.highWater, matchArena.capacity);
+	resetArena(&matchArena);
+	for(int i = 0; i < numberOfShips; i++) globalShips[i] = NULL;
+	ownHitmap = NULL;
+	opponentHitmap = NULL;
+	clearFleet(&fleet);
 }
 
 void destroy() {
-	SDL_DestroyTexture(gridSquareA);
-	SDL_DestroyTexture(gridSquareB);
-	SDL_DestroyTexture(mouseOverlay);
-	SDL_DestroyTexture(shipFront);
-	SDL_DestroyTexture(shipMiddle);
-	SDL_DestroyTexture(shipBack);
-	SDL_DestroyTexture(hitOverlay);
-	SDL_DestroyTexture(missedOverlay);
+	if(isFleetSearchRunning()) { // Its threads read the ships
+		FleetLayout layout;
+		collectFleetSearch(&layout);
+	}
+	// Quitting mid-match leaves the network thread running: it still uses the match arena and may call into the
+	// plugin, so both are left for the process exit to reclaim
+	if(networkThread == NULL) {
+		if(strategyPlugin.strategy != NULL) {
+			if(strategyState != NULL) strategyPlugin.strategy->destroy(strategyState);
+			strategyState = NULL;
+			unloadStrategyPlugin(&strategyPlugin);
+		}
+		freeArena(&matchArena);
+	}
+	for(int i = 0; i < numberOfShips; i++) freeShip(shipDefinitions[i]);
+	destroyTrackedTexture(MEM_ASSETS, spriteAtlas);
+	invalidateBoardLayer();
+	printTextCacheStats();
+	destroyTextCache();
+	destroyGlyphAtlas();
+	printf("Memory still in use on exit:\n");
+	printMemoryReport(stdout);
+	TTF_CloseFont(mainFont);
+	TTF_Quit();
+	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 	SDL_Quit();
 }
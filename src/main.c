@@ -1,11 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "globals.h"
 #include "load.h"
 #include "game.h"
 
 void printUsageAndQuit(char* programName) {
-	fprintf(stderr, "Usage: %s <nickname> [<address> <port>]\nDefault address and port are localhost and 9098.\n", programName);
+	fprintf(stderr, "Usage: %s [-s <strategy plugin>] <nickname> [<address> <port> [<fleet file>]]\nDefault address and port are localhost and 9098, default fleet file is resources/fleet.txt.\nWith a strategy plugin, it places the fleet and plays every turn.\n", programName);
 	exit(1);
 }
 
@@ -14,8 +15,16 @@ int main(int argc, char** argv) {
 	squareHeight = 60;
 	cols = 10;
 	rows = 10;
+	fleetPath = "resources/fleet.txt";
 
-	if(argc == 1 || argc == 3 || argc > 4) printUsageAndQuit(argv[0]);
+	if(argc > 2 && strcmp(argv[1], "-s") == 0) { // Strategy plugin, then the usual arguments
+		strategyPath = argv[2];
+		argv[2] = argv[0];
+		argv += 2;
+		argc -= 2;
+	}
+
+	if(argc == 1 || argc == 3 || argc > 5) printUsageAndQuit(argv[0]);
 	else {
 		if(argc == 2) { // Only nickname provided
 			serverAddress = "localhost";
@@ -27,6 +36,10 @@ int main(int argc, char** argv) {
 			serverPort = strtol(argv[3], NULL, 10);
 			if(serverPort < 1 || serverPort > 65535) printUsageAndQuit(argv[0]);
 			printf("Using server %s:%ld\n", serverAddress, serverPort);
+			if(argc == 5) {
+				fleetPath = argv[4];
+				printf("Using fleet %s\n", fleetPath);
+			}
 		}
 		nickname = argv[1];
 		if(strlen(nickname) > 15) {
@@ -0,0 +1,82 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "memstats.h"
+
+// Counters are atomic because the network thread allocates too; reports may be off by an allocation in flight.
+typedef struct {
+	atomic_size_t liveBytes;
+	atomic_size_t liveCount;
+	atomic_size_t totalCount;
+	atomic_size_t peakBytes;
+} MemStats;
+
+static MemStats memStats[MEM_TAG_COUNT];
+static MemStats totalStats;
+static const char* memTagNames[MEM_TAG_COUNT] = { "ships", "hitmaps", "network", "text", "assets" };
+
+static void addLiveBytes(MemStats* stats, size_t size) {
+	size_t live = atomic_fetch_add(&stats->liveBytes, size) + size;
+	size_t peak = atomic_load(&stats->peakBytes);
+	while(live > peak && !atomic_compare_exchange_weak(&stats->peakBytes, &peak, live));
+}
+
+void recordAllocation(enum MemTagEnum tag, size_t size) {
+	MemStats* stats[2] = { &memStats[tag], &totalStats };
+	for(int i = 0; i < 2; i++) {
+		addLiveBytes(stats[i], size);
+		atomic_fetch_add(&stats[i]->liveCount, 1);
+		atomic_fetch_add(&stats[i]->totalCount, 1);
+	}
+}
+
+// Releases count allocations of size bytes in total.
+void recordRelease(enum MemTagEnum tag, size_t size, size_t count) {
+	MemStats* stats[2] = { &memStats[tag], &totalStats };
+	for(int i = 0; i < 2; i++) {
+		atomic_fetch_sub(&stats[i]->liveBytes, size);
+		atomic_fetch_sub(&stats[i]->liveCount, count);
+	}
+}
+
+void* trackedMalloc(enum MemTagEnum tag, size_t size) {
+	void* memory = malloc(size);
+	if(memory != NULL) recordAllocation(tag, size);
+	return memory;
+}
+
+// Growing an allocation keeps counting it as one; oldSize must be 0 when memory is NULL.
+void* trackedRealloc(enum MemTagEnum tag, void* memory, size_t oldSize, size_t size) {
+	void* grown = realloc(memory, size);
+	if(grown == NULL) return NULL;
+	if(memory == NULL) {
+		recordAllocation(tag, size);
+	}
+	else {
+		atomic_fetch_sub(&memStats[tag].liveBytes, oldSize);
+		atomic_fetch_sub(&totalStats.liveBytes, oldSize);
+		addLiveBytes(&memStats[tag], size);
+		addLiveBytes(&totalStats, size);
+	}
+	return grown;
+}
+
+void trackedFree(enum MemTagEnum tag, void* memory, size_t size) {
+	if(memory == NULL) return;
+	free(memory);
+	recordRelease(tag, size, 1);
+}
+
+// Returns how many allocations have been made so far, by every subsystem.
+size_t getAllocationCount() {
+	return atomic_load(&totalStats.totalCount);
+}
+
+// Prints live bytes and allocations, allocations made so far and the high-water mark of every subsystem.
+void printMemoryReport(FILE* out) {
+	fprintf(out, "%-10s %12s %8s %8s %12s\n", "subsystem", "live bytes", "live", "allocs", "peak bytes");
+	for(int i = 0; i <= MEM_TAG_COUNT; i++) {
+		MemStats* stats = i < MEM_TAG_COUNT ? &memStats[i] : &totalStats;
+		fprintf(out, "%-10s %12zu %8zu %8zu %12zu\n", i < MEM_TAG_COUNT ? memTagNames[i] : "total", atomic_load(&stats->liveBytes),
+			atomic_load(&stats->liveCount), atomic_load(&stats->totalCount), atomic_load(&stats->peakBytes));
+	}
+}
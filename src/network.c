@@ -1,25 +1,25 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_net.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "load.h"
 #include "network.h"
 #include "globals.h"
+#include "framer.h"
+#include "transport.h"
+#include "protocol.h"
+#include "outbuffer.h"
+#include "rules.h"
 
 NetworkState networkState;
+Uint32 networkEventType;
+MessageFramer serverFramer;
+unsigned char binaryProtocol;
+OutputBuffer requestBuffer;
 
 // Initializes the network part of the application.
 void initNetwork() {
-    if(SDLNet_Init() != 0) {
-        fprintf(stderr, "Error: couldn't initialize SDLNet:\n%s\n", SDLNet_GetError());
-        exit(1);
-    }
-    IPaddress* ipAddress = malloc(sizeof(IPaddress));
-    if(SDLNet_ResolveHost(ipAddress, serverAddress, serverPort) != 0) {
-        fprintf(stderr, "Error: couldn't resolve host:\n%s\n", SDLNet_GetError());
-        exit(1);
-    }
+    initTransport();
 
     networkState.mutex = SDL_CreateMutex();
     if(!networkState.mutex) {
@@ -33,7 +33,13 @@ void initNetwork() {
     }
     networkState.state = CONNECTING;
 
-    networkThread = SDL_CreateThread(networkMain, "network", ipAddress);
+    networkEventType = SDL_RegisterEvents(1);
+    if(networkEventType == (Uint32) -1) {
+        fprintf(stderr, "Error: couldn't register network event:\n%s\n", SDL_GetError());
+        exit(1);
+    }
+
+    networkThread = SDL_CreateThread(networkMain, "network", NULL);
     if(!networkThread) {
         fprintf(stderr, "Error: couldn't create network thread:\n%s\n", SDL_GetError());
         exit(1);
@@ -42,22 +48,9 @@ void initNetwork() {
 
 // Handles everything that has to do with communicating with the server. Should be run as a thread.
 int networkMain(void* data) {
-    IPaddress* ipAddress = (IPaddress*) data;
-
-    socketSet = SDLNet_AllocSocketSet(1);
-    if(!socketSet) {
-        fprintf(stderr, "Error: couldn't allocate socketset for server:\n%s\n", SDL_GetError());
-        exit(1);
-    }
-
-    serverSocket = SDLNet_TCP_Open(ipAddress);
-    if(!serverSocket) {
-        fprintf(stderr, "Error: couldn't connect to server:\n%s\n", SDLNet_GetError());
-        exit(1);
-    }
-    free(ipAddress);
-
-    SDLNet_TCP_AddSocket(socketSet, serverSocket);
+    connectToServer(serverAddress, serverPort, setConnectionTimings);
+    initFramer(&serverFramer);
+    initOutputBuffer(&requestBuffer, &matchArena);
 
     // Now run the hello request
     // If server responds wait_match, wait until it sends matched
@@ -85,7 +78,9 @@ int networkMain(void* data) {
         }
     }
 
-    SDLNet_TCP_Close(serverSocket);
+    freeOutputBuffer(&requestBuffer);
+    closeTransport();
+    return 0;
 }
 
 // Locks the SDL_mutex passed to it.
@@ -96,11 +91,42 @@ void lockMutex(SDL_mutex* m) {
     }
 }
 
+// Wakes up the game loop so that it shows a change made by the network thread.
+void notifyNetworkChange() {
+    SDL_Event ev;
+    SDL_zero(ev);
+    ev.type = networkEventType;
+    if(SDL_PushEvent(&ev) < 0) {
+        fprintf(stderr, "Error: couldn't push network event:\n%s\n", SDL_GetError());
+        exit(1);
+    }
+}
+
+// Publishes the progress of connecting to the server, shown by the connecting scene.
+void setConnectionTimings(const ConnectionTimings* timings) {
+    lockMutex(networkState.mutex);
+    networkState.connection = *timings;
+    SDL_UnlockMutex(networkState.mutex);
+    if(timings->stage == CONNECTED) {
+        printf("Connected to %s (%s): %d address(es) resolved in %lu ms, connected in %lu ms after %d attempt(s).\n",
+               serverAddress, timings->address, timings->addressCount, timings->resolveMs, timings->connectMs, timings->attempts);
+    }
+    notifyNetworkChange();
+}
+
+// Gets the progress of connecting to the server thread-safely.
+void getConnectionTimings(ConnectionTimings* timings) {
+    lockMutex(networkState.mutex);
+    *timings = networkState.connection;
+    SDL_UnlockMutex(networkState.mutex);
+}
+
 // Sets the state field of the networkState variable thread-safely.
 void setNetworkState(enum NetworkStateEnum s) {
     lockMutex(networkState.mutex);
     networkState.state = s;
     SDL_UnlockMutex(networkState.mutex);
+    notifyNetworkChange();
 }
 
 // Gets the state field of the networkState variable thread-safely
@@ -111,45 +137,61 @@ enum NetworkStateEnum getNetworkState() {
     return s;
 }
 
-// Waits until server sends something, and copies it into response.
-// maxResponseLength is the size of the response string.
-void waitForServer(char* response, int maxResponseLength) {
-    while(!SDLNet_CheckSockets(socketSet, 1000)); // Need this to wait
-
-    while(SDLNet_CheckSockets(socketSet, 0) && SDLNet_SocketReady(serverSocket)) { // Need this to receive until end
-        // Receive 256 bytes at a time
-        char buf[256] = "";
-        int result = SDLNet_TCP_Recv(serverSocket, buf, 256);
-        if(result < 0) {
-            fprintf(stderr, "Error: couldn't receive from server:\n%s\n", SDLNet_GetError());
-            exit(1);
-        }
-        else if(result == 0) {
-            printf("Server closed connection.\n");
-            exit(1);
-        }
+// Waits until the server has sent a complete message and makes message point to it.
+// The message stays valid until the next call; bytes received past its end are kept for the next one.
+void waitForServer(MessageView* message) {
+    while(!nextMessage(&serverFramer, message)) {
+        waitTransport(&serverFramer, 0);
+    }
+}
 
-        if(maxResponseLength - strlen(response) < strlen(buf)) {
-            fprintf(stderr, "Error: server's response to request too big.\n");
-            exit(1);
-        }
+// Waits for the next message from the server and decodes it with the negotiated protocol.
+void waitServerMessage(ServerMessage* message) {
+    MessageView raw;
+    waitForServer(&raw);
+    if(binaryProtocol) decodeBinaryMessage(raw, message);
+    else decodeTextMessage(raw, message);
+}
 
-        strcat(response, buf);
+// Exits because the server sent message when it wasn't expected; context tells when it happened.
+void failOnMessage(const ServerMessage* message, const char* context) {
+    if(binaryProtocol) {
+        fprintf(stderr, "Error: server returned following %s:\nbinary message of type 0x%02x\n", context,
+                message->header.length > 0 ? (unsigned char) message->header.data[0] : 0);
     }
+    else {
+        fprintf(stderr, "Error: server returned following %s:\n%.*s\n", context, (int) message->header.length, message->header.data);
+    }
+    exit(1);
 }
 
 // Waits until networkState.clientInfo == 1 thread-safely.
+// With the native transport, whatever the server sends meanwhile is read and kept for the next waitForServer.
 void waitForClientSignal() {
     lockMutex(networkState.mutex);
     while(!networkState.clientInfo) {
+#ifdef BATTLESHIP_NATIVE_NET
+        SDL_UnlockMutex(networkState.mutex);
+        if(waitTransport(&serverFramer, 1) == TRANSPORT_RECEIVED) {
+            printf("Server sent data while waiting for the player; it'll be handled afterwards.\n");
+        }
+        lockMutex(networkState.mutex);
+#else
         if(SDL_CondWait(networkState.clientSignal, networkState.mutex) != 0) {
             fprintf(stderr, "Error: couldn't wait for client signal correctly.\n");
             exit(1);
         }
+#endif
     }
     SDL_UnlockMutex(networkState.mutex);
 }
 
+// Tells the network thread that networkState.clientInfo was set. networkState.mutex must be locked.
+void signalClientInfo() {
+    SDL_CondSignal(networkState.clientSignal);
+    wakeTransport();
+}
+
 // Sets networkState.clientInfo back to 0 thread-safely
 void zeroClientSignal() {
     lockMutex(networkState.mutex);
@@ -157,93 +199,70 @@ void zeroClientSignal() {
     SDL_UnlockMutex(networkState.mutex);
 }
 
-// Runs the request contained in message and waits until the server responds, then copies the output into response
-void runRequest(const char* message, char* response, int maxResponseLength) {
-    if(SDLNet_TCP_Send(serverSocket, message, strlen(message) + 1) < strlen(message) + 1) {
-        fprintf(stderr, "Error: couldn't send initial message to server:\n%s\n", SDLNet_GetError());
-        exit(1);
-    }
-    waitForServer(response, maxResponseLength);
+// Sends the request built in requestBuffer with a single send, then waits for the server's answer and decodes it.
+void runRequest(ServerMessage* response) {
+    sendToServer(requestBuffer.data, requestBuffer.length);
+    waitServerMessage(response);
 }
 
 // Runs the hello request, to be sent as soon as connected to the server.
+// Both protocol versions are offered; the binary one is used from then on if the server answers with its version.
 char runHelloRequest() { // Returns 0 if not matched yet, 1 if already matched
-    char helloMessage[256];
-    sprintf(helloMessage, "hello\r\nversion " PROTOCOL_VERSION "\r\nname %s\r\nrows %d\r\ncols %d\r\n\r\n", nickname, rows, cols);
+    resetOutputBuffer(&requestBuffer);
+    encodeTextHello(&requestBuffer, nickname, rows, cols);
 
-    char serverResponse[512];
-    runRequest(helloMessage, serverResponse, 512);
+    ServerMessage serverResponse;
+    runRequest(&serverResponse);
 
-    char* lineSavePtr;
-    char* header = strtok_r(serverResponse, "\r\n", &lineSavePtr);
-    if(header == NULL) {
-        fprintf(stderr, "Error: server's response after hello request only contained newlines.\n");
-        exit(1);
+    if(viewEquals(serverResponse.version, BINARY_PROTOCOL_VERSION)) {
+        binaryProtocol = 1;
+        serverFramer.binary = 1;
+        printf("Server supports protocol " BINARY_PROTOCOL_VERSION ", switching to binary messages.\n");
     }
 
-    if(strcmp(header, "wait_match") == 0) {
+    if(serverResponse.type == SERVER_WAIT_MATCH) {
         setNetworkState(WAITING_MATCH);
         printf("Server responded to hello message with wait_match.\n");
 
         return 0;
     }
 
-    else if(strcmp(header, "matched") == 0) {
-        handleMatched(&lineSavePtr);
+    else if(serverResponse.type == SERVER_MATCHED) {
+        handleMatched(&serverResponse);
         printf("Server responded to hello message with matched. Opponent's nickname: %s.\n", opponentNickname);
 
         return 1;
     }
 
     else {
-        fprintf(stderr, "Error: server returned following on response to hello message:\n%s\n", header);
+        failOnMessage(&serverResponse, "on response to hello message");
+        return -1;
     }
 }
 
 // Waits until the server sends a "matched" message.
 void waitMatched() {
-    char serverResponse[512] = "";
-    waitForServer(serverResponse, 512);
-    
-    char* lineSavePtr;
-    char* header = strtok_r(serverResponse, "\r\n", &lineSavePtr);
-    
-    if(strcmp(header, "matched") == 0) {
-        handleMatched(&lineSavePtr);
+    ServerMessage serverResponse;
+    waitServerMessage(&serverResponse);
+
+    if(serverResponse.type == SERVER_MATCHED) {
+        handleMatched(&serverResponse);
         printf("Server sent matched. Opponent's nickname: %s.\n", opponentNickname);
     }
     else {
-        fprintf(stderr, "Error: server returned following while waiting for match:\n%s\n", header);
-        exit(1);
+        failOnMessage(&serverResponse, "while waiting for match");
     }
 }
 
 // Handles a matched message and copies the opponent's nickname in the opponentNickname global variable.
-void handleMatched(char** lineSavePtr) {
-    char* line = strtok_r(NULL, "\r\n", lineSavePtr);
-    if(line == NULL) {
+void handleMatched(const ServerMessage* message) {
+    if(message->name.length == 0) {
         fprintf(stderr, "Error: server returned matched header, but didn't give opponent's nickname.\n");
         exit(1);
     }
-
-    char* argSavePtr;
-    char* param = strtok_r(line, " ", &argSavePtr);
-    if(param == NULL) {
-        fprintf(stderr, "Error: couldn't get opponent's nickname.\n");
-        exit(1);
-    }
-    if(strcmp(param, "name") == 0) {
-        char* name = strtok_r(NULL, " ", &argSavePtr);
-        if(name == NULL) {
-            fprintf(stderr, "Error: couldn't get opponent's nickname.\n");
-            exit(1);
-        }
-        strcpy(opponentNickname, name);
-    }
-    else {
-        fprintf(stderr, "Error: server returned invalid parameter on 'matched' response.\n");
-        exit(1);
-    }
+    size_t length = message->name.length < sizeof(opponentNickname) - 1 ? message->name.length : sizeof(opponentNickname) - 1;
+    memcpy(opponentNickname, message->name.data, length);
+    opponentNickname[length] = '\0';
 
     setNetworkState(PLACING_SHIPS);
 }
@@ -251,91 +270,96 @@ void handleMatched(char** lineSavePtr) {
 // Runs the ready request; must be called when the ships have been completely placed.
 // Returns 0 if server responds wait_ships, 1 if your_turn, 2 if wait_turn
 char runReadyRequest() {
-    char msg[65535];
-
-    char* stringified = stringifyShips(ships, 5);
-    if(stringified == NULL) {
-        fprintf(stderr, "Error: trying to run ready request, but ships cannot be stringified.\n");
+    if(validateFleet(&fleet, numberOfShips, &gridMask) != RULE_OK) {
+        fprintf(stderr, "Error: trying to run ready request, but the fleet isn't valid.\n");
         exit(1);
     }
-    sprintf(msg, "ready\r\n%s\r\n\r\n", stringified);
-    free(stringified);
+    resetOutputBuffer(&requestBuffer);
+    if(binaryProtocol) encodeBinaryReady(&requestBuffer, fleet.ships, fleet.count, rows, cols);
+    else encodeTextReady(&requestBuffer, fleet.ships, fleet.count);
 
     printf("Running ready request\n");
-    char serverResponse[512] = "";
-    runRequest(msg, serverResponse, 512);
+    ServerMessage serverResponse;
+    runRequest(&serverResponse);
 
-    char* lineSavePtr;
-    char* header = strtok_r(serverResponse, "\r\n", &lineSavePtr);
-    if(header == NULL) {
-        fprintf(stderr, "Error: server's response after ready request only contained newlines.\n");
-        exit(1);
-    }
-
-    if(strcmp(header, "wait_ships") == 0) {
+    if(serverResponse.type == SERVER_WAIT_SHIPS) {
         setNetworkState(WAITING_SHIPS);
         printf("Server responded to ready message with wait_ships.\n");
 
         return 0;
     }
 
-    else if(strcmp(header, "your_turn") == 0) {
+    else if(serverResponse.type == SERVER_YOUR_TURN) {
         setNetworkState(OWN_TURN);
         printf("Server reponded to ready message with your_turn.\n");
         return 1;
     }
 
-    else if(strcmp(header, "wait_turn") == 0) {
+    else if(serverResponse.type == SERVER_WAIT_TURN) {
         setNetworkState(WAITING_TURN);
         printf("Server responded to ready message with wait_turn.\n");
         return 2;
     }
 
     else {
-        fprintf(stderr, "Error: server returned following on response to ready message:\n%s\n", header);
-        exit(1);
+        failOnMessage(&serverResponse, "on response to ready message");
+        return -1;
     }
 }
 
 // Waits until the server sends your_turn or wait_turn (i. e. until the opponent has finished placing their ships)
 char waitOpponentShipsPlaced() {
-    char serverResponse[512] = "";
-    waitForServer(serverResponse, 512);
-    
-    char* lineSavePtr;
-    char* header = strtok_r(serverResponse, "\r\n", &lineSavePtr);
-    
-    if(strcmp(header, "your_turn") == 0) {
+    ServerMessage serverResponse;
+    waitServerMessage(&serverResponse);
+
+    if(serverResponse.type == SERVER_YOUR_TURN) {
         setNetworkState(OWN_TURN);
         printf("Server sent your_turn.\n");
         return 1;
     }
     
-    else if(strcmp(header, "wait_turn") == 0) {
+    else if(serverResponse.type == SERVER_WAIT_TURN) {
         setNetworkState(WAITING_TURN);
         printf("Server sent wait_turn.\n");
         return 2;
     }
 
     else {
-        fprintf(stderr, "Error: server returned following while waiting for match:\n%s\n", header);
-        exit(1);
+        failOnMessage(&serverResponse, "while waiting for the opponent's ships");
+        return -1;
     }
 }
 
-// Sets a field in a Hitmap thread-safely
-void setHitmapField(Hitmap* hitmap, int x, int y, char value) {
-    lockMutex(hitmap->mutex);
-    hitmap->map[y][x] = value;
-    SDL_UnlockMutex(hitmap->mutex);
+// Records the result of an attack on the opponent's field. When a ship is sunk, its cells are worked out from the hits.
+void recordOwnAttack(int x, int y, enum AttackOutcomeEnum outcome) {
+    setHitmapField(opponentHitmap, x, y, outcome == ATTACK_MISS ? 1 : 2);
+    if(outcome == ATTACK_SUNK) {
+        HitmapBuffer snapshot;
+        Bitboard sunkShip;
+        getHitmapSnapshot(opponentHitmap, &snapshot);
+        findSunkShip(&snapshot, x, y, &sunkShip);
+        markHitmapSunk(opponentHitmap, &sunkShip);
+    }
+    // The render thread only calls the plugin on our turn, which has ended by the time the result arrives
+    if(strategyState != NULL) {
+        int result = outcome == ATTACK_MISS ? STRATEGY_RESULT_MISS : outcome == ATTACK_HIT ? STRATEGY_RESULT_HIT : STRATEGY_RESULT_SUNK;
+        strategyPlugin.strategy->observe(strategyState, x, y, result);
+    }
 }
 
-// Gets a field in a Hitmap thread-safely
-char getHitmapField(Hitmap* hitmap, int x, int y) {
-    lockMutex(hitmap->mutex);
-    char value = hitmap->map[y][x];
-    SDL_UnlockMutex(hitmap->mutex);
-    return value;
+// Records an attack of the opponent on the own field, checking the server's result against the local rules.
+void recordOpponentAttack(int x, int y, enum AttackOutcomeEnum reported) {
+    HitmapBuffer snapshot;
+    Bitboard sunkShip;
+    getHitmapSnapshot(ownHitmap, &snapshot);
+    enum AttackOutcomeEnum expected = resolveAttack(&fleet, &snapshot.hits, x, y, &sunkShip);
+    if(expected == ATTACK_FLEET_SUNK) expected = ATTACK_SUNK;
+    if(expected != reported) {
+        fprintf(stderr, "Warning: server reported result %d for the opponent's attack on %d %d, expected %d.\n", reported, x, y, expected);
+    }
+
+    setHitmapField(ownHitmap, x, y, reported == ATTACK_MISS ? 1 : 2);
+    if(reported == ATTACK_SUNK && expected == ATTACK_SUNK) markHitmapSunk(ownHitmap, &sunkShip);
 }
 
 // Handles player's turn
@@ -348,147 +372,133 @@ char handleOwnTurn() {
     int y = networkState.y;
     SDL_UnlockMutex(networkState.mutex);
 
-    char msg[512];
-    sprintf(msg, "attack\r\n%d %d\r\n\r\n", x, y);
-
-    char serverResponse[512] = "";
-    runRequest(msg, serverResponse, 512);
+    resetOutputBuffer(&requestBuffer);
+    if(binaryProtocol) encodeBinaryAttack(&requestBuffer, x, y);
+    else encodeTextAttack(&requestBuffer, x, y);
 
-    char* lineSavePtr;
-    char* header = strtok_r(serverResponse, "\r\n", &lineSavePtr);
-    if(header == NULL) {
-        fprintf(stderr, "Error: server response after attack only contained newlines.\n");
-        exit(1);
-    }
+    ServerMessage serverResponse;
+    runRequest(&serverResponse);
 
     char result;
     lockMutex(networkState.mutex);
 
-    if(strcmp(header, "no_hit") == 0) {
+    if(serverResponse.type == SERVER_NO_HIT) {
         networkState.hittingState = NO_HIT;
         networkState.state = WAITING_TURN;
-        setHitmapField(opponentHitmap, x, y, 1);
+        recordOwnAttack(x, y, ATTACK_MISS);
         result = 2;
     }
 
-    else if(strcmp(header, "hit") == 0) {
+    else if(serverResponse.type == SERVER_HIT) {
         networkState.hittingState = HIT;
         networkState.state = WAITING_TURN;
-        setHitmapField(opponentHitmap, x, y, 2);
+        recordOwnAttack(x, y, ATTACK_HIT);
         result = 2;
     }
 
-    else if(strcmp(header, "hit_sunk") == 0) {
+    else if(serverResponse.type == SERVER_HIT_SUNK) {
         networkState.hittingState = HIT_SUNK;
         networkState.state = WAITING_TURN;
-        setHitmapField(opponentHitmap, x, y, 2);
+        recordOwnAttack(x, y, ATTACK_SUNK);
         result = 2;
     }
 
-    else if(strcmp(header, "you_win") == 0) {
+    else if(serverResponse.type == SERVER_YOU_WIN) {
         networkState.hittingState = END;
         networkState.state = WON;
         result = 3;
     }
 
-    else if(strcmp(header, "you_lose") == 0) {
+    else if(serverResponse.type == SERVER_YOU_LOSE) {
         networkState.hittingState = END;
         networkState.state = LOST;
         result = 4;
     }
 
     else {
-        fprintf(stderr, "Error: server returned following response to attack message:\n%s\n", header);
-        exit(1);
+        failOnMessage(&serverResponse, "response to attack message");
     }
     networkState.clientInfo = 0;
     SDL_UnlockMutex(networkState.mutex);
+    notifyNetworkChange();
     return result;
 }
 
-// Interprets a string containing two numbers and writes them on two ints.
-// Usually this is the second line of a no_hit, hit or hit_sunk message, which contains the coordinates.
-void getOpponentActionCoords(char* secondLine, int* x, int* y) {
-    char wrongFormatError[] = "Error: server sent badly formatted opponent action coordinates.\n";
-    if(secondLine == NULL) {
-        fprintf(stderr, wrongFormatError);
-        exit(1);
-    }
-    if(sscanf(secondLine, "%d %d", x, y) != 2) {
-        fprintf(stderr, wrongFormatError);
+// Gets the coordinates of an opponent's action, checking that they're a cell of the grid.
+void getOpponentActionCoords(const ServerMessage* message, int* x, int* y) {
+    if(!message->hasCoords || message->x < 0 || message->x >= cols || message->y < 0 || message->y >= rows) {
+        fprintf(stderr, "Error: server sent badly formatted opponent action coordinates.\n");
         exit(1);
     }
+    *x = message->x;
+    *y = message->y;
 }
 
 // Handles the turn of the opponent.
 // Returns 1 on turn ended normally, 3 if won, 4 if lost.
 char handleOpponentTurn() {
-    char serverResponse[512] = "";
-    waitForServer(serverResponse, 512);
+    ServerMessage serverResponse;
+    waitServerMessage(&serverResponse);
 
-    char* lineSavePtr;
-    char* header = strtok_r(serverResponse, "\r\n", &lineSavePtr);
-    if(header == NULL) {
-        fprintf(stderr, "Error: server sent only newlines as opponent's action.\n");
-        exit(1);
-    }
-
-    char* secondLine = strtok_r(NULL, "\r\n", &lineSavePtr);
-
-    if(strcmp(header, "no_hit") == 0) {
+    if(serverResponse.type == SERVER_NO_HIT) {
         int x, y;
-        getOpponentActionCoords(secondLine, &x, &y);
+        getOpponentActionCoords(&serverResponse, &x, &y);
 
         lockMutex(networkState.mutex);
         networkState.hittingState = NO_HIT;
         networkState.state = OWN_TURN;
-        setHitmapField(ownHitmap, x, y, 1);
+        recordOpponentAttack(x, y, ATTACK_MISS);
         SDL_UnlockMutex(networkState.mutex);
+        notifyNetworkChange();
         return 1;
     }
 
-    else if(strcmp(header, "hit") == 0) {
+    else if(serverResponse.type == SERVER_HIT) {
         int x, y;
-        getOpponentActionCoords(secondLine, &x, &y);
+        getOpponentActionCoords(&serverResponse, &x, &y);
 
         lockMutex(networkState.mutex);
         networkState.hittingState = HIT;
         networkState.state = OWN_TURN;
-        setHitmapField(ownHitmap, x, y, 2);
+        recordOpponentAttack(x, y, ATTACK_HIT);
         SDL_UnlockMutex(networkState.mutex);
+        notifyNetworkChange();
         return 1;
     }
 
-    else if(strcmp(header, "hit_sunk") == 0) {
+    else if(serverResponse.type == SERVER_HIT_SUNK) {
         int x, y;
-        getOpponentActionCoords(secondLine, &x, &y);
+        getOpponentActionCoords(&serverResponse, &x, &y);
 
         lockMutex(networkState.mutex);
         networkState.hittingState = HIT_SUNK;
         networkState.state = OWN_TURN;
-        setHitmapField(ownHitmap, x, y, 2);
+        recordOpponentAttack(x, y, ATTACK_SUNK);
         SDL_UnlockMutex(networkState.mutex);
+        notifyNetworkChange();
         return 1;
     }
 
-    else if(strcmp(header, "you_win") == 0) {
+    else if(serverResponse.type == SERVER_YOU_WIN) {
         lockMutex(networkState.mutex);
         networkState.hittingState = END;
         networkState.state = WON;
         SDL_UnlockMutex(networkState.mutex);
+        notifyNetworkChange();
         return 3;
     }
 
-    else if(strcmp(header, "you_lose") == 0) {
+    else if(serverResponse.type == SERVER_YOU_LOSE) {
         lockMutex(networkState.mutex);
         networkState.hittingState = END;
         networkState.state = LOST;
         SDL_UnlockMutex(networkState.mutex);
+        notifyNetworkChange();
         return 4;
     }
 
     else {
-        fprintf(stderr, "Error: server returned following response as opponent's action:\n%s\n", header);
-        exit(1);
+        failOnMessage(&serverResponse, "response as opponent's action");
+        return -1;
     }
 }
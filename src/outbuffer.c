@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "outbuffer.h"
+
+void initOutputBuffer(OutputBuffer* buffer, Arena* arena) {
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    buffer->arena = arena;
+}
+
+void freeOutputBuffer(OutputBuffer* buffer) {
+    if(buffer->arena == NULL) trackedFree(MEM_NETWORK, buffer->data, buffer->capacity);
+    initOutputBuffer(buffer, buffer->arena);
+}
+
+void resetOutputBuffer(OutputBuffer* buffer) {
+    buffer->length = 0;
+}
+
+// Makes sure that size more bytes can be written without growing the buffer again.
+void reserveOutputBuffer(OutputBuffer* buffer, size_t size) {
+    if(buffer->capacity - buffer->length >= size) return;
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : 256;
+    while(capacity - buffer->length < size) capacity *= 2;
+    char* data;
+    if(buffer->arena != NULL) {
+        data = arenaAlloc(buffer->arena, capacity, MEM_NETWORK);
+        if(buffer->length > 0) memcpy(data, buffer->data, buffer->length);
+    }
+    else {
+        data = trackedRealloc(MEM_NETWORK, buffer->data, buffer->capacity, capacity);
+    }
+    if(data == NULL) {
+        fprintf(stderr, "Error: couldn't allocate memory for an output buffer.\n");
+        exit(1);
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+}
+
+// Appends size bytes to the buffer without initializing them and returns where they start, for encoders that fill
+// in fixed-size fields directly.
+char* claimOutputBuffer(OutputBuffer* buffer, size_t size) {
+    reserveOutputBuffer(buffer, size);
+    char* start = buffer->data + buffer->length;
+    buffer->length += size;
+    return start;
+}
+
+void writeBytes(OutputBuffer* buffer, const void* data, size_t size) {
+    memcpy(claimOutputBuffer(buffer, size), data, size);
+}
+
+void writeString(OutputBuffer* buffer, const char* string) {
+    writeBytes(buffer, string, strlen(string));
+}
+
+void writeChar(OutputBuffer* buffer, char c) {
+    *claimOutputBuffer(buffer, 1) = c;
+}
+
+// Writes value in decimal, like "%d" would.
+void writeInt(OutputBuffer* buffer, int value) {
+    size_t length = getIntLength(value);
+    char* p = claimOutputBuffer(buffer, length);
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int) value : (unsigned int) value;
+    if(value < 0) p[0] = '-';
+    char* digit = p + length;
+    do {
+        *--digit = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while(magnitude > 0);
+}
+
+// Returns how many characters writeInt writes for value.
+size_t getIntLength(int value) {
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int) value : (unsigned int) value;
+    size_t length = value < 0 ? 2 : 1;
+    while(magnitude >= 10) {
+        magnitude /= 10;
+        length++;
+    }
+    return length;
+}
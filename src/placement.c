@@ -0,0 +1,117 @@
+#include <string.h>
+#include "placement.h"
+#include "random.h"
+
+// Gives up on a fleet that doesn't fit after this many fleets have been thrown away
+#define MAX_PLACEMENT_ATTEMPTS 100000
+
+// Computes the placements of ships in grid and the heat map used to score fleets. Returns 0 if a ship doesn't fit in
+// the grid at all.
+unsigned char initFleetPlacer(FleetPlacer* placer, Ship* const* ships, int count, const Bitboard* grid) {
+	placer->count = count;
+	for(int i = 0; i < count; i++) {
+		placer->ships[i] = ships[i];
+		placer->placementCounts[i] = 0;
+		for(int r = 0; r < NUMBER_OF_ORIENTATIONS; r++) {
+			const ShipOrientation* orientation = &ships[i]->orientations[r];
+			Bitboard* anchors = &placer->anchors[i][r];
+			clearBitboard(anchors);
+			for(int y = 0; y + orientation->height <= BITBOARD_MAX_SIZE; y++) {
+				for(int x = 0; x + orientation->width <= BITBOARD_STRIDE; x++) {
+					Bitboard mask;
+					shiftBitboard(&mask, &orientation->shape, x, y);
+					if(bitboardIsSubset(&mask, grid)) setBit(anchors, x, y);
+				}
+			}
+			placer->anchorCounts[i][r] = countBits(anchors);
+			placer->placementCounts[i] += placer->anchorCounts[i][r];
+		}
+		if(placer->placementCounts[i] == 0) return 0;
+	}
+
+	HitmapBuffer empty;
+	memset(&empty, 0, sizeof(empty));
+	computeDensityMap(&placer->heat, &empty, grid, (const Ship* const*) ships, count);
+	// A shared side costs as much as an average cell: ships next to each other are found together in target mode
+	long totalHeat = 0;
+	for(int bit = 0; bit < DENSITY_CELLS; bit++) totalHeat += placer->heat.cells[bit];
+	placer->touchPenalty = (int) (totalHeat / countBits(grid));
+	return 1;
+}
+
+// Picks one of the placements of ship i inside the grid, each with the same probability.
+static void pickPlacement(const FleetPlacer* placer, int i, uint64_t* rng, FleetLayout* layout) {
+	int n = randomBelow(rng, placer->placementCounts[i]);
+	int r = 0;
+	while(n >= placer->anchorCounts[i][r]) n -= placer->anchorCounts[i][r++];
+	int bit = nthBit(&placer->anchors[i][r], n);
+	const ShipOrientation* orientation = &placer->ships[i]->orientations[r];
+	layout->rotations[i] = (char) r;
+	layout->x[i] = bit % BITBOARD_STRIDE - orientation->left;
+	layout->y[i] = bit / BITBOARD_STRIDE - orientation->top;
+	shiftBitboard(&layout->masks[i], &orientation->shape, bit % BITBOARD_STRIDE, bit / BITBOARD_STRIDE);
+}
+
+// Samples a fleet uniformly among all legal fleets: every ship goes on a random spot of the empty grid, and the whole
+// fleet is thrown away as soon as two ships overlap. Unlike placing each ship among the spots left by the previous
+// ones, this doesn't favor the spots the first ships leave free. Returns 0 if no legal fleet has been found.
+unsigned char sampleRandomFleet(const FleetPlacer* placer, FleetLayout* layout, uint64_t* rng) {
+	for(int attempt = 0; attempt < MAX_PLACEMENT_ATTEMPTS; attempt++) {
+		clearBitboard(&layout->occupied);
+		int i;
+		for(i = 0; i < placer->count; i++) {
+			pickPlacement(placer, i, rng, layout);
+			if(bitboardsIntersect(&layout->masks[i], &layout->occupied)) break;
+			orBitboard(&layout->occupied, &layout->masks[i]);
+		}
+		if(i == placer->count) return 1;
+	}
+	return 0;
+}
+
+// Scores a fleet against the usual targeting bots; lower is better. Hunting bots attack where most placements are
+// possible first, and once they hit a ship they attack its neighbours, which finds ships touching it too.
+int scoreFleetLayout(const FleetPlacer* placer, const FleetLayout* layout) {
+	int score = 0;
+	for(int bit = nextBit(&layout->occupied, 0); bit != -1; bit = nextBit(&layout->occupied, bit + 1)) {
+		score += placer->heat.cells[bit];
+	}
+	for(int i = 0; i < placer->count; i++) {
+		Bitboard others = layout->occupied;
+		andNotBitboard(&others, &layout->masks[i]);
+		for(int bit = nextBit(&layout->masks[i], 0); bit != -1; bit = nextBit(&layout->masks[i], bit + 1)) {
+			int x = bit % BITBOARD_STRIDE;
+			int y = bit / BITBOARD_STRIDE;
+			int shared = (x > 0 && testBit(&others, x - 1, y)) + (x < BITBOARD_STRIDE - 1 && testBit(&others, x + 1, y))
+				+ (y > 0 && testBit(&others, x, y - 1)) + (y < BITBOARD_MAX_SIZE - 1 && testBit(&others, x, y + 1));
+			score += shared * placer->touchPenalty;
+		}
+	}
+	return score;
+}
+
+// Samples candidates random fleets and keeps the one with the lowest score. Returns 0 if no legal fleet was found.
+unsigned char sampleBestFleet(const FleetPlacer* placer, int candidates, uint64_t* rng, FleetLayout* best, int* bestScore) {
+	unsigned char found = 0;
+	FleetLayout candidate;
+	for(int i = 0; i < candidates; i++) {
+		if(!sampleRandomFleet(placer, &candidate, rng)) break;
+		int score = scoreFleetLayout(placer, &candidate);
+		if(!found || score < *bestScore) {
+			*best = candidate;
+			*bestScore = score;
+			found = 1;
+		}
+	}
+	return found;
+}
+
+// Moves the count ships where layout puts them and adds them to fleet, in order.
+void applyFleetLayout(const FleetLayout* layout, Ship** ships, int count, Fleet* fleet) {
+	for(int i = 0; i < count; i++) {
+		ships[i]->rotation = layout->rotations[i];
+		ships[i]->x = layout->x[i];
+		ships[i]->y = layout->y[i];
+		addShipToFleet(fleet, ships[i]);
+	}
+}
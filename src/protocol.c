@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "protocol.h"
+
+// Text headers of the messages the server can send, indexed by ServerMessageEnum
+const char* serverHeaders[] = {
+    "",
+    "wait_match",
+    "matched",
+    "wait_ships",
+    "your_turn",
+    "wait_turn",
+    "no_hit",
+    "hit",
+    "hit_sunk",
+    "you_win",
+    "you_lose"
+};
+
+// Decodes a message of the text protocol (1.0): a header line, then "name <nickname>", "version <version>"
+// or "<x> <y>" lines depending on the message.
+void decodeTextMessage(MessageView message, ServerMessage* out) {
+    memset(out, 0, sizeof(*out));
+    if(!nextLine(&message, &out->header)) return;
+    for(int i = SERVER_WAIT_MATCH; i <= SERVER_YOU_LOSE; i++) {
+        if(viewEquals(out->header, serverHeaders[i])) {
+            out->type = (enum ServerMessageEnum) i;
+            break;
+        }
+    }
+
+    MessageView line;
+    while(nextLine(&message, &line)) {
+        MessageView first, second;
+        if(!nextToken(&line, &first)) continue;
+        if(viewEquals(first, "name")) {
+            nextToken(&line, &out->name);
+        }
+        else if(viewEquals(first, "version")) {
+            nextToken(&line, &out->version);
+        }
+        else if(!out->hasCoords && parseViewInt(first, &out->x) && nextToken(&line, &second) && parseViewInt(second, &out->y)) {
+            out->hasCoords = 1;
+        }
+    }
+}
+
+// Decodes the body of a binary protocol (2.0) frame.
+void decodeBinaryMessage(MessageView message, ServerMessage* out) {
+    memset(out, 0, sizeof(*out));
+    out->header = message;
+    if(message.length == 0) return;
+    const unsigned char* data = (const unsigned char*) message.data;
+
+    switch(data[0]) {
+    case BINARY_WAIT_MATCH: out->type = SERVER_WAIT_MATCH; break;
+    case BINARY_WAIT_SHIPS: out->type = SERVER_WAIT_SHIPS; break;
+    case BINARY_YOUR_TURN: out->type = SERVER_YOUR_TURN; break;
+    case BINARY_WAIT_TURN: out->type = SERVER_WAIT_TURN; break;
+    case BINARY_YOU_WIN: out->type = SERVER_YOU_WIN; break;
+    case BINARY_YOU_LOSE: out->type = SERVER_YOU_LOSE; break;
+    case BINARY_MATCHED:
+        if(message.length < 2 || message.length < 2 + (size_t) data[1]) return;
+        out->type = SERVER_MATCHED;
+        out->name.data = message.data + 2;
+        out->name.length = data[1];
+        break;
+    case BINARY_NO_HIT:
+    case BINARY_HIT:
+    case BINARY_HIT_SUNK:
+        if(message.length < 3) return;
+        out->type = data[0] == BINARY_NO_HIT ? SERVER_NO_HIT : data[0] == BINARY_HIT ? SERVER_HIT : SERVER_HIT_SUNK;
+        out->hasCoords = 1;
+        out->x = data[1];
+        out->y = data[2];
+        break;
+    default:
+        break;
+    }
+}
+
+// Text requests are terminated by an empty line and a NUL byte, which servers of protocol 1.0 expect on the wire.
+// Their exact size is computed first, so that the buffer grows at most once per message.
+#define HELLO_PREFIX "hello\r\nversion " PROTOCOL_VERSION " " BINARY_PROTOCOL_VERSION "\r\nname "
+
+void encodeTextHello(OutputBuffer* out, const char* nickname, int rows, int cols) {
+    reserveOutputBuffer(out, strlen(HELLO_PREFIX) + strlen(nickname) + strlen("\r\nrows ") + getIntLength(rows)
+                             + strlen("\r\ncols ") + getIntLength(cols) + strlen("\r\n\r\n") + 1);
+    writeString(out, HELLO_PREFIX);
+    writeString(out, nickname);
+    writeString(out, "\r\nrows ");
+    writeInt(out, rows);
+    writeString(out, "\r\ncols ");
+    writeInt(out, cols);
+    writeString(out, "\r\n\r\n");
+    writeChar(out, '\0');
+}
+
+void encodeTextReady(OutputBuffer* out, Ship** ships, int amount) {
+    reserveOutputBuffer(out, strlen("ready\r\n") + getShipsTextSize(ships, amount) + strlen("\r\n\r\n") + 1);
+    writeString(out, "ready\r\n");
+    stringifyShips(out, ships, amount);
+    writeString(out, "\r\n\r\n");
+    writeChar(out, '\0');
+}
+
+void encodeTextAttack(OutputBuffer* out, int x, int y) {
+    reserveOutputBuffer(out, strlen("attack\r\n") + getIntLength(x) + 1 + getIntLength(y) + strlen("\r\n\r\n") + 1);
+    writeString(out, "attack\r\n");
+    writeInt(out, x);
+    writeChar(out, ' ');
+    writeInt(out, y);
+    writeString(out, "\r\n\r\n");
+    writeChar(out, '\0');
+}
+
+// Writes the frame header for a body of the given length.
+void writeBinaryFrameHeader(unsigned char* out, size_t bodyLength) {
+    out[0] = (unsigned char) (bodyLength >> 8);
+    out[1] = (unsigned char) (bodyLength & 0xFF);
+}
+
+// Gets the size of a binary ready frame, so that the caller can provide a big enough buffer.
+size_t getBinaryReadySize(int amount, int rows, int cols) {
+    size_t maskSize = ((size_t) rows * cols + 7) / 8;
+    return BINARY_FRAME_HEADER_SIZE + 4 + (size_t) amount * (1 + maskSize);
+}
+
+// Appends a binary ready frame to out.
+// Each ship is sent as its index and a bitmask of the cells it covers (bit y * cols + x, least significant first).
+void encodeBinaryReady(OutputBuffer* out, Ship** ships, int amount, int rows, int cols) {
+    size_t maskSize = ((size_t) rows * cols + 7) / 8;
+    size_t size = getBinaryReadySize(amount, rows, cols);
+    unsigned char* frame = (unsigned char*) claimOutputBuffer(out, size);
+    writeBinaryFrameHeader(frame, size - BINARY_FRAME_HEADER_SIZE);
+
+    unsigned char* p = frame + BINARY_FRAME_HEADER_SIZE;
+    *p++ = BINARY_READY;
+    *p++ = (unsigned char) rows;
+    *p++ = (unsigned char) cols;
+    *p++ = (unsigned char) amount;
+    for(int i = 0; i < amount; i++) {
+        Ship* ship = ships[i];
+        *p++ = ship->index;
+        memset(p, 0, maskSize);
+        Bitboard mask;
+        if(getShipMask(ship, &mask)) {
+            for(int bit = nextBit(&mask, 0); bit != -1; bit = nextBit(&mask, bit + 1)) {
+                int boardX = bit % BITBOARD_STRIDE, boardY = bit / BITBOARD_STRIDE;
+                if(boardX >= cols || boardY >= rows) continue;
+                int packed = boardY * cols + boardX;
+                p[packed / 8] |= (unsigned char) (1 << (packed % 8));
+            }
+        }
+        p += maskSize;
+    }
+}
+
+// Appends a binary attack frame to out.
+void encodeBinaryAttack(OutputBuffer* out, int x, int y) {
+    unsigned char* frame = (unsigned char*) claimOutputBuffer(out, BINARY_ATTACK_SIZE);
+    writeBinaryFrameHeader(frame, BINARY_ATTACK_SIZE - BINARY_FRAME_HEADER_SIZE);
+    frame[2] = BINARY_ATTACK;
+    frame[3] = (unsigned char) x;
+    frame[4] = (unsigned char) y;
+}
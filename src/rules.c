@@ -0,0 +1,47 @@
+#include "rules.h"
+
+// An attack must target a cell of the grid that hasn't been attacked yet.
+enum RuleResultEnum validateAttack(const HitmapBuffer* hitmap, const Bitboard* grid, int x, int y) {
+	if(x < 0 || x >= BITBOARD_STRIDE || y < 0 || y >= BITBOARD_MAX_SIZE || !testBit(grid, x, y)) return RULE_OUT_OF_GRID;
+	if(testBit(&hitmap->misses, x, y) || testBit(&hitmap->hits, x, y)) return RULE_ALREADY_ATTACKED;
+	return RULE_OK;
+}
+
+// A fleet is ready when every ship has been placed inside the grid and no two ships share a cell.
+enum RuleResultEnum validateFleet(const Fleet* fleet, int numberOfShips, const Bitboard* grid) {
+	if(fleet->count != numberOfShips) return RULE_FLEET_INCOMPLETE;
+	Bitboard occupied;
+	clearBitboard(&occupied);
+	for(int i = 0; i < fleet->count; i++) {
+		Bitboard mask;
+		if(!getShipMask(fleet->ships[i], &mask) || !bitboardIsSubset(&mask, grid)) return RULE_SHIP_OUT_OF_GRID;
+		if(bitboardsIntersect(&mask, &occupied)) return RULE_SHIPS_OVERLAP;
+		orBitboard(&occupied, &mask);
+	}
+	return RULE_OK;
+}
+
+// Works out what the server answers to an attack on (x, y) against fleet, given the cells already hit.
+// When a ship is sunk, its cells are written to sunkShip.
+enum AttackOutcomeEnum resolveAttack(const Fleet* fleet, const Bitboard* hits, int x, int y, Bitboard* sunkShip) {
+	if(!testBit(&fleet->occupied, x, y)) return ATTACK_MISS;
+
+	Bitboard allHits = *hits;
+	setBit(&allHits, x, y);
+	for(int i = 0; i < fleet->count; i++) {
+		if(!testBit(&fleet->masks[i], x, y)) continue;
+		if(!bitboardIsSubset(&fleet->masks[i], &allHits)) return ATTACK_HIT;
+		*sunkShip = fleet->masks[i];
+		return bitboardIsSubset(&fleet->occupied, &allHits) ? ATTACK_FLEET_SUNK : ATTACK_SUNK;
+	}
+	return ATTACK_HIT;
+}
+
+// Guesses the cells of an opponent's ship that has just been sunk at (x, y): the hit cells connected to it that
+// aren't part of a ship sunk earlier. Ships that touch each other can make the guess too big.
+void findSunkShip(const HitmapBuffer* hitmap, int x, int y, Bitboard* sunkShip) {
+	Bitboard candidates = hitmap->hits;
+	andNotBitboard(&candidates, &hitmap->sunk);
+	setBit(&candidates, x, y);
+	floodFillBitboard(sunkShip, &candidates, x, y);
+}
@@ -6,6 +6,8 @@
 #include "game.h"
 #include "network.h"
 #include "userstrings.h"
+#include "batch.h"
+#include "rules.h"
 
 char runConnectingScene() {
 	SDL_Event ev;
@@ -17,10 +19,22 @@ char runConnectingScene() {
 	SDL_RenderClear(renderer);
 
 	char status[256];
-	sprintf(status, CONNECTING_MSG, serverAddress);
+	ConnectionTimings timings;
+	getConnectionTimings(&timings);
+	switch(timings.stage) {
+	case RESOLVING:
+		snprintf(status, sizeof(status), CONNECTING_MSG, serverAddress);
+		break;
+	case RACING:
+		snprintf(status, sizeof(status), CONNECTING_RESOLVED_MSG, serverAddress, timings.addressCount, timings.resolveMs);
+		break;
+	case CONNECTED:
+		snprintf(status, sizeof(status), CONNECTING_CONNECTED_MSG, timings.address, timings.connectMs, timings.resolveMs);
+		break;
+	}
 	setStatusBar(status);
 
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -36,7 +50,7 @@ char runMatchWaitingScene() {
 
 	setStatusBar(CONNECTED_MSG);
 
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -53,10 +67,7 @@ char runShipPlacementScene() {
 	int gridWidth = squareWidth * cols;
 	int gridHeight = squareHeight * rows;
 
-	drawGrid(squareWidth, squareHeight);
-	drawGrid(gridWidth + 2 * squareWidth, squareHeight);
-	drawGridCoords(0, 0, 0);
-	drawGridCoords(gridWidth + squareWidth, 0, 1);
+	drawBoard();
 	drawPlacedShips(squareWidth, squareHeight);
 	
 	lockMutex(networkState.mutex);
@@ -64,16 +75,36 @@ char runShipPlacementScene() {
 	SDL_UnlockMutex(networkState.mutex);
 
 	if(ci == 0) {
-		unsigned char allPlaced = handleShipPlacement(squareWidth, squareHeight, gridWidth, gridHeight, state);
-		if(allPlaced) {
+		unsigned char allPlaced;
+		if(isFleetSearchRunning()) {
+			allPlaced = autoPlaceFleet(AUTO_PLACE_OPTIMIZED);
+		}
+		else if(autoPlay && !autoPlaceFailed) { // After a failure, the ships are placed by hand
+			allPlaced = autoPlaceFleet(strategyState != NULL ? AUTO_PLACE_STRATEGY : AUTO_PLACE_OPTIMIZED);
+		}
+		else if(autoPlaceRequest != AUTO_PLACE_NONE) {
+			allPlaced = autoPlaceFleet(autoPlaceRequest);
+			autoPlaceRequest = AUTO_PLACE_NONE;
+		}
+		else {
+			allPlaced = handleShipPlacement(squareWidth, squareHeight, gridWidth, gridHeight, state);
+		}
+		if(allPlaced && validateFleet(&fleet, numberOfShips, &gridMask) != RULE_OK) {
+			// The placement scene never produces such a fleet, but the server would refuse it, so take the last ship back
+			Ship* lastShip = removeLastShipFromFleet(&fleet);
+			globalShips[lastShip->index] = lastShip;
+			currentShip = lastShip->index;
+			setStatusBar(FLEET_INVALID_MSG);
+		}
+		else if(allPlaced) {
 			lockMutex(networkState.mutex);
 			networkState.clientInfo = 1;
-			SDL_CondSignal(networkState.clientSignal);
+			signalClientInfo();
 			SDL_UnlockMutex(networkState.mutex);
 		}
 	}
 	
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -87,20 +118,14 @@ char runShipWaitingScene() {
 
 	SDL_RenderClear(renderer);
 
-	int gridWidth = squareWidth * cols;
-	int gridHeight = squareHeight * rows;
-
-	drawGrid(squareWidth, squareHeight);
-	drawGrid(gridWidth + 2 * squareWidth, squareHeight);
-	drawGridCoords(0, 0, 0);
-	drawGridCoords(gridWidth + squareWidth, 0, 1);
+	drawBoard();
 	drawPlacedShips(squareWidth, squareHeight);
 
 	char status[256];
 	sprintf(status, WAIT_SHIPS_MSG, opponentNickname);
 	setStatusBar(status);
 	
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -117,10 +142,7 @@ char runOwnTurnScene() {
 	int gridWidth = squareWidth * cols;
 	int gridHeight = squareHeight * rows;
 
-	drawGrid(squareWidth, squareHeight);
-	drawGrid(gridWidth + 2 * squareWidth, squareHeight);
-	drawGridCoords(0, 0, 0);
-	drawGridCoords(gridWidth + squareWidth, 0, 1);
+	drawBoard();
 	drawPlacedShips(squareWidth, squareHeight);
 	drawHitmap(ownHitmap, squareWidth, squareHeight);
 	drawHitmap(opponentHitmap, gridWidth + 2 * squareWidth, squareHeight);
@@ -132,7 +154,7 @@ char runOwnTurnScene() {
 		handleAttack(gridWidth + 2 * squareWidth, squareHeight, gridWidth, gridHeight, state);
 	}
 
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -149,10 +171,7 @@ char runTurnWaitingScene() {
 	int gridWidth = squareWidth * cols;
 	int gridHeight = squareHeight * rows;
 
-	drawGrid(squareWidth, squareHeight);
-	drawGrid(gridWidth + 2 * squareWidth, squareHeight);
-	drawGridCoords(0, 0, 0);
-	drawGridCoords(gridWidth + squareWidth, 0, 1);
+	drawBoard();
 	drawPlacedShips(squareWidth, squareHeight);
 	drawHitmap(ownHitmap, squareWidth, squareHeight);
 	drawHitmap(opponentHitmap, gridWidth + 2 * squareWidth, squareHeight);
@@ -161,7 +180,7 @@ char runTurnWaitingScene() {
 	sprintf(status, WAIT_TURN_MSG, opponentNickname);
 	setStatusBar(status);
 	
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -177,7 +196,7 @@ char runWonScene() {
 
 	setStatusBar(YOU_WIN_MSG);
 
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -193,7 +212,7 @@ char runLostScene() {
 
 	setStatusBar(YOU_LOSE_MSG);
 
-	SDL_RenderPresent(renderer);
+	presentFrame();
 
 	return state;
 }
@@ -1,186 +1,244 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "globals.h"
-#include "load.h"
 #include "ship.h"
+#include "memstats.h"
 
 Ship* makeShip(const char name[20], unsigned char index, int sizeY, int sizeX) {
-	Ship* ship = malloc(sizeof(Ship));
+	Ship* ship = trackedMalloc(MEM_SHIPS, sizeof(Ship));
 	if(ship == NULL) {
 		printf("Error: couldn't allocate memory for the ship.\n");
 		exit(1);
 	}
+	if(sizeY > SHIP_MATRIX_SIZE || sizeX > SHIP_MATRIX_SIZE) {
+		printf("Error: ship matrices can be at most %dx%d.\n", SHIP_MATRIX_SIZE, SHIP_MATRIX_SIZE);
+		exit(1);
+	}
 	strncpy(ship->name, name, 20);
 	ship->index = index;
 	ship->rotation = 0;
 	ship->sizeY = sizeY;
 	ship->sizeX = sizeX;
-	ship->matrix = allocateAndZeroMatrix(sizeY, sizeX);
+	memset(ship->matrix, 0, sizeof(ship->matrix));
+	buildShipOrientations(ship);
 
 	return ship;
 }
 
 Ship* copyShip(Ship* src) {
-	Ship* dst = makeShip(src->name, src->index, src->sizeX, src->sizeY);
-	dst->rotation = src->rotation;
-	dst->x = src->x;
-	dst->y = src->y;
-	copyMatrix(dst->matrix, src->matrix, src->sizeY, src->sizeX);
+	Ship* dst = trackedMalloc(MEM_SHIPS, sizeof(Ship));
+	if(dst == NULL) {
+		printf("Error: couldn't allocate memory for the ship.\n");
+		exit(1);
+	}
+	*dst = *src;
 	return dst;
 }
 
 void freeShip(Ship* ship) {
-	freeMatrix(ship->matrix, ship->sizeY, ship->sizeX);
-}
-
-void nextShip() {
-	do {
-		currentShip = (currentShip + 1) % NUMBER_OF_SHIPS;
-	} while(globalShips[currentShip] == 0);
+	trackedFree(MEM_SHIPS, ship, sizeof(Ship));
 }
 
-void previousShip() {
-	do {
-		currentShip = (NUMBER_OF_SHIPS + currentShip - 1) % NUMBER_OF_SHIPS;
-	} while(globalShips[currentShip] == 0);
+// Fills the shape, extents and part list of an orientation from its matrix.
+static void buildOrientation(ShipOrientation* orientation) {
+	int top = SHIP_MATRIX_SIZE, bottom = -1, left = SHIP_MATRIX_SIZE, right = -1;
+	orientation->partCount = 0;
+	for(int y = 0; y < SHIP_MATRIX_SIZE; y++) {
+		for(int x = 0; x < SHIP_MATRIX_SIZE; x++) {
+			if(orientation->matrix[y][x] != 0) {
+				if(y < top) top = y;
+				if(y > bottom) bottom = y;
+				if(x < left) left = x;
+				if(x > right) right = x;
+				ShipPart* part = &orientation->parts[orientation->partCount++];
+				part->x = x;
+				part->y = y;
+				part->type = orientation->matrix[y][x];
+			}
+		}
+	}
+	clearBitboard(&orientation->shape);
+	if(bottom < 0) { // Empty matrix
+		orientation->top = orientation->left = 0;
+		orientation->height = orientation->width = 0;
+		return;
+	}
+	orientation->top = top;
+	orientation->left = left;
+	orientation->height = bottom - top + 1;
+	orientation->width = right - left + 1;
+	for(int i = 0; i < orientation->partCount; i++) {
+		setBit(&orientation->shape, orientation->parts[i].x - left, orientation->parts[i].y - top);
+	}
 }
 
-void getShipEdges(Ship* ship, int* top, int* bottom, int* left, int* right) {
-	*top = 4;
-	*bottom = 0;
-	*left = 4;
-	*right = 0;
-	for(int y = 0; y < 5; y++) {
-		for(int x = 0; x < 5; x++) {
-			if(ship->matrix[y][x] != 0) {
-				if(y < *top) *top = y;
-				if(y > *bottom) *bottom = y;
-				if(x < *left) *left = x;
-				if(x > *right) *right = x;
+// Precomputes the four orientations of the ship from its matrix; must be called whenever the matrix changes.
+// Each orientation is the previous one turned 90 degrees clockwise around the center of the matrix.
+void buildShipOrientations(Ship* ship) {
+	memcpy(ship->orientations[0].matrix, ship->matrix, sizeof(ship->matrix));
+	for(int r = 0; r < NUMBER_OF_ORIENTATIONS; r++) {
+		ShipOrientation* orientation = &ship->orientations[r];
+		if(r > 0) {
+			const ShipOrientation* previous = &ship->orientations[r - 1];
+			for(int y = 0; y < SHIP_MATRIX_SIZE; y++) {
+				for(int x = 0; x < SHIP_MATRIX_SIZE; x++) {
+					orientation->matrix[x][SHIP_MATRIX_SIZE - 1 - y] = previous->matrix[y][x];
+				}
 			}
 		}
+		orientation->angle = r * 90.0;
+		buildOrientation(orientation);
 	}
 }
 
-void changeShipRotation(Ship* ship, int size) {
-	char mirror;
-	switch(ship->rotation) {
-	case 0:
-		ship->rotation = 1;
-		mirror = 1;
-		break;
-	case 1:
-		ship->rotation = 2;
-		mirror = 0;
-		break;
-	case 2:
-		ship->rotation = 3;
-		mirror = 1;
-		break;
-	case 3:
-		ship->rotation = 0;
-		mirror = 0;
-		break;
-	default:
-		printf("Error: invalid rotation value for ship: %d.\n", ship->rotation);
+// Gets the cells the ship covers at its current position. Returns 0 if the ship is out of the bitboard's range.
+unsigned char getShipMask(Ship* ship, Bitboard* mask) {
+	const ShipOrientation* orientation = getShipOrientation(ship);
+	int x = ship->x + orientation->left;
+	int y = ship->y + orientation->top;
+	if(x < 0 || y < 0 || x + orientation->width > BITBOARD_STRIDE || y + orientation->height > BITBOARD_MAX_SIZE) return 0;
+	shiftBitboard(mask, &orientation->shape, x, y);
+	return 1;
+}
+
+unsigned char checkShipFitsGrid(Ship* ship, const Bitboard* grid) {
+	Bitboard mask;
+	return getShipMask(ship, &mask) && bitboardIsSubset(&mask, grid);
+}
+
+void clearFleet(Fleet* fleet) {
+	fleet->count = 0;
+	clearBitboard(&fleet->occupied);
+	fleet->version++;
+}
+
+// Adds a ship at its current position to the fleet; the caller checks that it fits the grid and doesn't collide.
+void addShipToFleet(Fleet* fleet, Ship* ship) {
+	if(fleet->count == MAX_SHIPS) {
+		printf("Error: a fleet can have at most %d ships.\n", MAX_SHIPS);
 		exit(1);
 	}
+	getShipMask(ship, &fleet->masks[fleet->count]);
+	orBitboard(&fleet->occupied, &fleet->masks[fleet->count]);
+	fleet->ships[fleet->count++] = ship;
+	fleet->version++;
+}
 
-	char** newMatrix = allocateAndZeroMatrix(size, size);
-	for(int y = 0; y < size; y++) {
-		for(int x = 0; x < size; x++) {
-			if(mirror) {
-				newMatrix[x][4 - y] = ship->matrix[y][x];
-			}
-			else {
-				newMatrix[x][y] = ship->matrix[y][x];
+// Removes the last placed ship from the fleet and returns it, or returns NULL if the fleet is empty.
+Ship* removeLastShipFromFleet(Fleet* fleet) {
+	if(fleet->count == 0) return NULL;
+	fleet->count--;
+	andNotBitboard(&fleet->occupied, &fleet->masks[fleet->count]);
+	fleet->version++;
+	return fleet->ships[fleet->count];
+}
+
+// Returns a placed ship sharing a cell with ship, or NULL. The occupied mask rules out most placements with a single AND.
+Ship* findFleetCollision(const Fleet* fleet, Ship* ship) {
+	Bitboard mask;
+	if(!getShipMask(ship, &mask)) return NULL;
+	if(!bitboardsIntersect(&mask, &fleet->occupied)) return NULL;
+	for(int i = 0; i < fleet->count; i++) {
+		if(bitboardsIntersect(&mask, &fleet->masks[i])) return fleet->ships[i];
+	}
+	return NULL;
+}
+
+// Recomputes the legal anchors of ship if the index was built for another ship, orientation or fleet.
+// This only happens when a ship is selected, rotated, placed or removed, not on every frame.
+void updatePlacementIndex(PlacementIndex* index, const Fleet* fleet, const Ship* ship, const Bitboard* grid) {
+	if(index->valid && index->ship == ship && index->rotation == ship->rotation && index->fleetVersion == fleet->version) return;
+
+	const ShipOrientation* orientation = getShipOrientation(ship);
+	clearBitboard(&index->anchors);
+	clearBitboard(&index->centers);
+	for(int y = 0; y + orientation->height <= BITBOARD_MAX_SIZE; y++) {
+		for(int x = 0; x + orientation->width <= BITBOARD_STRIDE; x++) {
+			Bitboard mask;
+			shiftBitboard(&mask, &orientation->shape, x, y);
+			if(!bitboardIsSubset(&mask, grid) || bitboardsIntersect(&mask, &fleet->occupied)) continue;
+			setBit(&index->anchors, x, y);
+			int centerX = x - orientation->left + SHIP_MATRIX_SIZE / 2;
+			int centerY = y - orientation->top + SHIP_MATRIX_SIZE / 2;
+			if(centerX >= 0 && centerX < BITBOARD_STRIDE && centerY >= 0 && centerY < BITBOARD_MAX_SIZE) {
+				setBit(&index->centers, centerX, centerY);
 			}
 		}
 	}
-	copyMatrix(ship->matrix, newMatrix, size, size);
-	freeMatrix(newMatrix, size, size);
+	andBitboard(&index->centers, grid);
+
+	index->ship = ship;
+	index->rotation = ship->rotation;
+	index->fleetVersion = fleet->version;
+	index->valid = 1;
+}
+
+void invalidatePlacementIndex(PlacementIndex* index) {
+	index->valid = 0;
+}
+
+void getShipEdges(Ship* ship, int* top, int* bottom, int* left, int* right) {
+	const ShipOrientation* orientation = getShipOrientation(ship);
+	*top = orientation->top;
+	*bottom = orientation->top + orientation->height - 1;
+	*left = orientation->left;
+	*right = orientation->left + orientation->width - 1;
+}
+
+void changeShipRotation(Ship* ship) {
+	ship->rotation = (ship->rotation + 1) % NUMBER_OF_ORIENTATIONS;
 }
 
+// Ships collide only if they share a cell; touching ships, even diagonally, are a legal placement.
 unsigned char checkShipCollision(Ship* ship1, Ship* ship2) {
-	int top1, bottom1, left1, right1, top2, bottom2, left2, right2;
-	getShipEdges(ship1, &top1, &bottom1, &left1, &right1);
-	getShipEdges(ship2, &top2, &bottom2, &left2, &right2);
-	top1 += ship1->y;
-	bottom1 += ship1->y;
-	left1 += ship1->x;
-	right1 += ship1->x;
-	top2 += ship2->y;
-	bottom2 += ship2->y;
-	left2 += ship2->x;
-	right2 += ship2->x;
-	int dx1 = left1 - right2;
-	int dx2 = left2 - right1;
-	int dy1 = top1 - bottom2;
-	int dy2 = top2 - bottom1;
-	if(dx1 > 0 || dx2 > 0 || dy1 > 0 || dy2 > 0) return 0;
-	return 1;
+	Bitboard mask1, mask2;
+	if(!getShipMask(ship1, &mask1) || !getShipMask(ship2, &mask2)) return 1;
+	return bitboardsIntersect(&mask1, &mask2);
 }
 
-void dynamicStrcat(char** str, char* str2) {
-	if(*str != NULL && str2 == NULL) { // reset *str
-		free(*str);
-		*str = NULL;
-		return;
-	}
-	else if(*str == NULL) { // make new *str
-		*str = malloc(strlen(str2) + 1 * sizeof(char));
-		strcpy(*str, str2);
-	} else { // append str2 to *str
-		char* tmp = malloc((strlen(*str) + 1) * sizeof(char));
-		strcpy(tmp, *str);
-		*str = malloc((strlen(*str) + strlen(str2) + 1) * sizeof(char));
-		strcpy(*str, tmp);
-		strcpy(*str + strlen(*str), str2);
-		free(tmp);
-	}
+// Returns how many characters stringifyShip writes for ship.
+size_t getShipTextSize(Ship* ship) {
+	return strlen("ship_begin\r\nname ") + strlen(ship->name)
+		+ strlen("\r\ncoords ") + getIntLength(ship->x) + 1 + getIntLength(ship->y)
+		+ strlen("\r\nsize ") + getIntLength(ship->sizeX) + 1 + getIntLength(ship->sizeY)
+		+ strlen("\r\nmatrix_begin\r\n") + (size_t) ship->sizeY * (ship->sizeX + 2)
+		+ strlen("matrix_end\r\nship_end\r\n");
 }
 
-char* stringifyShip(Ship* ship) {
-	char* string = malloc(128 * sizeof(char));
-	string[0] = 0;
-	char tmp[128];
-	dynamicStrcat(&string, "ship_begin\r\n");
-	dynamicStrcat(&string, "name ");
-	dynamicStrcat(&string, ship->name);
-	dynamicStrcat(&string, "\r\ncoords ");
-	sprintf(tmp, "%d %d", ship->x, ship->y);
-	dynamicStrcat(&string, tmp);
-	dynamicStrcat(&string, "\r\nsize ");
-	sprintf(tmp, "%d %d", ship->sizeX, ship->sizeY);
-	dynamicStrcat(&string, tmp);
-	dynamicStrcat(&string, "\r\nmatrix_begin\r\n");
+void stringifyShip(OutputBuffer* out, Ship* ship) {
+	writeString(out, "ship_begin\r\nname ");
+	writeString(out, ship->name);
+	writeString(out, "\r\ncoords ");
+	writeInt(out, ship->x);
+	writeChar(out, ' ');
+	writeInt(out, ship->y);
+	writeString(out, "\r\nsize ");
+	writeInt(out, ship->sizeX);
+	writeChar(out, ' ');
+	writeInt(out, ship->sizeY);
+	writeString(out, "\r\nmatrix_begin\r\n");
+	const ShipOrientation* orientation = getShipOrientation(ship);
 	for(int y = 0; y < ship->sizeY; y++) {
 		for(int x = 0; x < ship->sizeX; x++) {
-			if(ship->matrix[y][x] == 0) {
-				tmp[0] = '*';
-				tmp[1] = 0;
-			} else {
-				sprintf(tmp, "%c", ship->matrix[y][x]);
-			}
-			dynamicStrcat(&string, tmp);
+			writeChar(out, orientation->matrix[y][x] == 0 ? '*' : orientation->matrix[y][x]);
 		}
-		dynamicStrcat(&string, "\r\n");
+		writeString(out, "\r\n");
 	}
-	dynamicStrcat(&string, "matrix_end\r\nship_end\r\n");
-	return string;
+	writeString(out, "matrix_end\r\nship_end\r\n");
 }
 
-char* stringifyShips(Ship** ships, int amount) {
-	for(int i = 0; i < amount; i++) if(ships[i] == NULL) return NULL;
-	char* string = malloc(1024 * sizeof(char));
-	string[0] = 0;
-	dynamicStrcat(&string, "ships_begin\r\n");
+// Returns how many characters stringifyShips writes for ships.
+size_t getShipsTextSize(Ship** ships, int amount) {
+	size_t size = strlen("ships_begin\r\n") + strlen("ships_end\r\n");
+	for(int i = 0; i < amount; i++) size += getShipTextSize(ships[i]);
+	return size;
+}
+
+void stringifyShips(OutputBuffer* out, Ship** ships, int amount) {
+	reserveOutputBuffer(out, getShipsTextSize(ships, amount));
+	writeString(out, "ships_begin\r\n");
 	for(int i = 0; i < amount; i++) {
-		char* stringified = stringifyShip(ships[i]);
-		dynamicStrcat(&string, stringified);
-		free(stringified);
+		stringifyShip(out, ships[i]);
 	}
-	dynamicStrcat(&string, "ships_end\r\n");
-	return string;
-}
\ No newline at end of file
+	writeString(out, "ships_end\r\n");
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+#include "strategyhost.h"
+
+_Static_assert(STRATEGY_SHIP_SIZE == SHIP_MATRIX_SIZE, "strategy ships must have the same matrix as Ship");
+
+// Loads the strategy plugin at path. Plugins that can't be loaded or were built for another ABI version are fatal.
+void loadStrategyPlugin(StrategyPlugin* plugin, const char* path) {
+	GetBattleshipStrategyFunction getStrategy;
+#if defined(_WIN32)
+	plugin->handle = LoadLibraryA(path);
+	if(plugin->handle == NULL) {
+		fprintf(stderr, "Error: couldn't load strategy plugin %s.\n", path);
+		exit(1);
+	}
+	getStrategy = (GetBattleshipStrategyFunction) GetProcAddress(plugin->handle, BATTLESHIP_STRATEGY_SYMBOL);
+#else
+	plugin->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if(plugin->handle == NULL) {
+		fprintf(stderr, "Error: couldn't load strategy plugin %s:\n%s\n", path, dlerror());
+		exit(1);
+	}
+	*(void**) &getStrategy = dlsym(plugin->handle, BATTLESHIP_STRATEGY_SYMBOL);
+#endif
+	if(getStrategy == NULL) {
+		fprintf(stderr, "Error: %s doesn't export %s.\n", path, BATTLESHIP_STRATEGY_SYMBOL);
+		exit(1);
+	}
+
+	plugin->strategy = getStrategy();
+	if(plugin->strategy == NULL || plugin->strategy->abiVersion != BATTLESHIP_STRATEGY_ABI_VERSION) {
+		fprintf(stderr, "Error: %s was built for another version of the strategy interface (expected %d).\n", path,
+			BATTLESHIP_STRATEGY_ABI_VERSION);
+		exit(1);
+	}
+	if(plugin->strategy->create == NULL || plugin->strategy->destroy == NULL || plugin->strategy->placeFleet == NULL
+		|| plugin->strategy->chooseAttack == NULL || plugin->strategy->observe == NULL) {
+		fprintf(stderr, "Error: strategy %s of %s doesn't implement every function.\n", plugin->strategy->name, path);
+		exit(1);
+	}
+}
+
+void unloadStrategyPlugin(StrategyPlugin* plugin) {
+#if defined(_WIN32)
+	FreeLibrary(plugin->handle);
+#else
+	dlclose(plugin->handle);
+#endif
+	plugin->handle = NULL;
+	plugin->strategy = NULL;
+}
+
+// Describes the game to a strategy. ships is filled from definitions and must outlive game.
+void describeStrategyGame(StrategyGame* game, StrategyShip ships[MAX_SHIPS], Ship* const* definitions, int count, int rows, int cols) {
+	for(int i = 0; i < count; i++) {
+		ships[i].name = definitions[i]->name;
+		ships[i].partCount = definitions[i]->orientations[0].partCount;
+		memcpy(ships[i].matrix, definitions[i]->matrix, sizeof(ships[i].matrix));
+	}
+	game->rows = rows;
+	game->cols = cols;
+	game->shipCount = count;
+	game->ships = ships;
+}
+
+// Converts what the player knows about the opponent's field to the cells passed to strategies.
+void getStrategyCells(unsigned char* cells, const HitmapBuffer* view, int rows, int cols) {
+	for(int y = 0; y < rows; y++) {
+		for(int x = 0; x < cols; x++) {
+			unsigned char cell = STRATEGY_CELL_UNKNOWN;
+			if(testBit(&view->sunk, x, y)) cell = STRATEGY_CELL_SUNK;
+			else if(testBit(&view->hits, x, y)) cell = STRATEGY_CELL_HIT;
+			else if(testBit(&view->misses, x, y)) cell = STRATEGY_CELL_MISS;
+			cells[y * cols + x] = cell;
+		}
+	}
+}
+
+// Checks the fleet placed by a strategy and converts it to a layout. Returns 0 if a ship is outside the grid or two
+// ships overlap.
+unsigned char getStrategyFleetLayout(const StrategyPlacement* placements, Ship* const* definitions, int count, const Bitboard* grid,
+	FleetLayout* layout) {
+	clearBitboard(&layout->occupied);
+	for(int i = 0; i < count; i++) {
+		if(placements[i].rotation < 0 || placements[i].rotation >= NUMBER_OF_ORIENTATIONS) return 0;
+		if(placements[i].x <= -SHIP_MATRIX_SIZE || placements[i].x >= BITBOARD_STRIDE) return 0;
+		if(placements[i].y <= -SHIP_MATRIX_SIZE || placements[i].y >= BITBOARD_MAX_SIZE) return 0;
+		Ship ship = *definitions[i];
+		ship.rotation = (char) placements[i].rotation;
+		ship.x = placements[i].x;
+		ship.y = placements[i].y;
+		if(!getShipMask(&ship, &layout->masks[i]) || !bitboardIsSubset(&layout->masks[i], grid)) return 0;
+		if(bitboardsIntersect(&layout->masks[i], &layout->occupied)) return 0;
+		orBitboard(&layout->occupied, &layout->masks[i]);
+		layout->rotations[i] = ship.rotation;
+		layout->x[i] = ship.x;
+		layout->y[i] = ship.y;
+	}
+	return 1;
+}
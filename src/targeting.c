@@ -0,0 +1,136 @@
+#include <string.h>
+#include "targeting.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Adds weight to the counter of every cell of mask, which only has cells in rows top to top + height - 1, saturating
+// at UINT16_MAX.
+static void addPlacement(DensityMap* map, const Bitboard* mask, int top, int height, uint16_t weight) {
+#if defined(__SSE2__)
+	const __m128i lowLanes = _mm_setr_epi16(0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80);
+	const __m128i highLanes = _mm_setr_epi16(0x100, 0x200, 0x400, 0x800, 0x1000, 0x2000, 0x4000, (short) 0x8000);
+	const __m128i weights = _mm_set1_epi16((short) weight);
+#endif
+	for(int y = top; y < top + height; y++) {
+		int bit = getBitIndex(0, y);
+		uint16_t row = (uint16_t) (mask->words[bit / 64] >> (bit % 64));
+		uint16_t* counters = &map->cells[bit];
+#if defined(__SSE2__)
+		// Spread the row over 16 lanes, turn the lanes of set bits into all ones and keep the weight there
+		__m128i bits = _mm_set1_epi16((short) row);
+		__m128i low = _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(bits, lowLanes), lowLanes), weights);
+		__m128i high = _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(bits, highLanes), highLanes), weights);
+		__m128i* lanes = (__m128i*) counters;
+		_mm_store_si128(lanes, _mm_adds_epu16(_mm_load_si128(lanes), low));
+		_mm_store_si128(lanes + 1, _mm_adds_epu16(_mm_load_si128(lanes + 1), high));
+#else
+		for(int x = 0; x < BITBOARD_STRIDE; x++) {
+			if(!(row >> x & 1)) continue;
+			counters[x] = UINT16_MAX - counters[x] < weight ? UINT16_MAX : counters[x] + weight;
+		}
+#endif
+	}
+}
+
+// Adds every placement of ships that avoids blocked. When hits isn't NULL, only placements covering some of them
+// count, weighted by how many they cover; a placement through more known hits is more likely. Returns how many counted.
+static int accumulatePlacements(DensityMap* map, const Bitboard* grid, const Bitboard* blocked, const Bitboard* hits,
+	const Ship* const* ships, int count) {
+	// Anchors are only tried within the bounding box of the grid
+	int gridRows = 0;
+	int gridCols = 0;
+	for(int bit = nextBit(grid, 0); bit != -1; bit = nextBit(grid, bit + 1)) {
+		if(bit / BITBOARD_STRIDE + 1 > gridRows) gridRows = bit / BITBOARD_STRIDE + 1;
+		if(bit % BITBOARD_STRIDE + 1 > gridCols) gridCols = bit % BITBOARD_STRIDE + 1;
+	}
+
+	int placements = 0;
+	for(int i = 0; i < count; i++) {
+		for(int r = 0; r < NUMBER_OF_ORIENTATIONS; r++) {
+			const ShipOrientation* orientation = &ships[i]->orientations[r];
+			// Symmetric ships look the same in more than one orientation; counting those twice would favor them
+			unsigned char seen = 0;
+			for(int p = 0; p < r && !seen; p++) {
+				const ShipOrientation* previous = &ships[i]->orientations[p];
+				seen = bitboardIsSubset(&previous->shape, &orientation->shape) && bitboardIsSubset(&orientation->shape, &previous->shape);
+			}
+			if(seen) continue;
+
+			for(int y = 0; y + orientation->height <= gridRows; y++) {
+				for(int x = 0; x + orientation->width <= gridCols; x++) {
+					Bitboard mask;
+					shiftBitboard(&mask, &orientation->shape, x, y);
+					if(!bitboardIsSubset(&mask, grid) || bitboardsIntersect(&mask, blocked)) continue;
+					int weight = 1;
+					if(hits != NULL) {
+						Bitboard covered = mask;
+						andBitboard(&covered, hits);
+						weight = countBits(&covered);
+						if(weight == 0) continue;
+					}
+					addPlacement(map, &mask, y, orientation->height, (uint16_t) weight);
+					placements++;
+				}
+			}
+		}
+	}
+	return placements;
+}
+
+// Works out which ships haven't been sunk yet: every group of connected sunk cells removes one ship with as many parts.
+// Returns how many ships were written to remaining.
+int getRemainingShips(const HitmapBuffer* hitmap, Ship* const* ships, int count, const Ship** remaining) {
+	unsigned char sunk[MAX_SHIPS] = { 0 };
+	Bitboard left = hitmap->sunk;
+	for(int bit = nextBit(&left, 0); bit != -1; bit = nextBit(&left, bit + 1)) {
+		Bitboard group;
+		floodFillBitboard(&group, &left, bit % BITBOARD_STRIDE, bit / BITBOARD_STRIDE);
+		andNotBitboard(&left, &group);
+		int size = countBits(&group);
+		for(int i = 0; i < count; i++) {
+			if(!sunk[i] && ships[i]->orientations[0].partCount == size) {
+				sunk[i] = 1;
+				break;
+			}
+		}
+	}
+
+	int remainingCount = 0;
+	for(int i = 0; i < count; i++) {
+		if(!sunk[i]) remaining[remainingCount++] = ships[i];
+	}
+	return remainingCount;
+}
+
+// Counts how many placements of the remaining ships cover each cell of the opponent's grid and picks the best cell to
+// attack. While there are hits that don't belong to a sunk ship (target mode), only placements through them count;
+// otherwise (hunt mode) every placement that avoids the misses and the sunk ships does.
+void computeDensityMap(DensityMap* map, const HitmapBuffer* hitmap, const Bitboard* grid, const Ship* const* ships, int count) {
+	memset(map->cells, 0, sizeof(map->cells));
+	Bitboard blocked = hitmap->misses;
+	orBitboard(&blocked, &hitmap->sunk);
+	Bitboard openHits = hitmap->hits;
+	andNotBitboard(&openHits, &hitmap->sunk);
+
+	map->targeting = !isBitboardEmpty(&openHits) && accumulatePlacements(map, grid, &blocked, &openHits, ships, count) > 0;
+	if(!map->targeting) accumulatePlacements(map, grid, &blocked, NULL, ships, count);
+
+	// Cells that have already been attacked can't be chosen; the first unattacked cell is the fallback
+	Bitboard candidates = *grid;
+	andNotBitboard(&candidates, &hitmap->misses);
+	andNotBitboard(&candidates, &hitmap->hits);
+	map->bestX = -1;
+	map->bestY = -1;
+	map->bestDensity = 0;
+	for(int bit = nextBit(&candidates, 0); bit != -1; bit = nextBit(&candidates, bit + 1)) {
+		if(map->bestX == -1 || map->cells[bit] > map->bestDensity) {
+			map->bestX = bit % BITBOARD_STRIDE;
+			map->bestY = bit / BITBOARD_STRIDE;
+			map->bestDensity = map->cells[bit];
+		}
+	}
+	for(int bit = 0; bit < DENSITY_CELLS; bit++) {
+		if(!testBit(&candidates, bit % BITBOARD_STRIDE, bit / BITBOARD_STRIDE)) map->cells[bit] = 0;
+	}
+}
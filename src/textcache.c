@@ -0,0 +1,89 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "load.h"
+#include "textcache.h"
+#include "memstats.h"
+
+TextCache textCache;
+
+// FNV-1a hash of a string, used to skip most string comparisons on lookup.
+static Uint32 hashText(const char* text) {
+	Uint32 hash = 2166136261u;
+	for(const char* c = text; *c; c++) {
+		hash ^= (Uint8) *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Returns a texture with text rendered in the given font and color, together with its size.
+// Textures are kept in a bounded LRU cache keyed by (font, text, color), so text is only rasterized
+// and uploaded when it actually changes. The returned texture is owned by the cache: don't destroy it.
+SDL_Texture* getCachedFontTexture(TTF_Font* font, const char* text, SDL_Color color, int* width, int* height) {
+	Uint32 hash = hashText(text);
+	TextCacheEntry* victim = &textCache.entries[0];
+	textCache.clock++;
+
+	for(int i = 0; i < TEXT_CACHE_SIZE; i++) {
+		TextCacheEntry* entry = &textCache.entries[i];
+		if(entry->texture == NULL) { // Free slots are always preferred over evicting
+			if(victim->texture != NULL) victim = entry;
+			continue;
+		}
+		if(entry->hash == hash && entry->font == font && memcmp(&entry->color, &color, sizeof color) == 0 && strcmp(entry->text, text) == 0) {
+			entry->lastUsed = textCache.clock;
+			textCache.hits++;
+			if(width != NULL) *width = entry->width;
+			if(height != NULL) *height = entry->height;
+			return entry->texture;
+		}
+		if(victim->texture != NULL && entry->lastUsed < victim->lastUsed) victim = entry;
+	}
+
+	textCache.misses++;
+	if(victim->texture != NULL) {
+		destroyTrackedTexture(MEM_TEXT, victim->texture);
+		trackedFree(MEM_TEXT, victim->text, strlen(victim->text) + 1);
+	}
+	victim->text = trackedMalloc(MEM_TEXT, strlen(text) + 1);
+	if(victim->text == NULL) {
+		printf("Error: couldn't allocate memory for text cache entry.\n");
+		exit(1);
+	}
+	strcpy(victim->text, text);
+	victim->font = font;
+	victim->color = color;
+	victim->hash = hash;
+	victim->lastUsed = textCache.clock;
+	victim->texture = getFontTexture(font, text, color);
+	if(SDL_QueryTexture(victim->texture, NULL, NULL, &victim->width, &victim->height) < 0) {
+		printf("Error: couldn't get font width and height:\n%s", SDL_GetError());
+		exit(1);
+	}
+
+	if(width != NULL) *width = victim->width;
+	if(height != NULL) *height = victim->height;
+	return victim->texture;
+}
+
+void printTextCacheStats() {
+	unsigned long lookups = textCache.hits + textCache.misses;
+	printf("Text cache: %lu hits, %lu misses (%.1f%% hit rate).\n", textCache.hits, textCache.misses,
+		lookups > 0 ? 100.0 * textCache.hits / lookups : 0.0);
+}
+
+// Releases every texture held by the text cache.
+void destroyTextCache() {
+	for(int i = 0; i < TEXT_CACHE_SIZE; i++) {
+		TextCacheEntry* entry = &textCache.entries[i];
+		if(entry->texture != NULL) {
+			destroyTrackedTexture(MEM_TEXT, entry->texture);
+			trackedFree(MEM_TEXT, entry->text, strlen(entry->text) + 1);
+			entry->texture = NULL;
+			entry->text = NULL;
+		}
+	}
+}
@@ -0,0 +1,280 @@
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "transport.h"
+
+// Linux transport: a non-blocking socket with TCP_NODELAY and an eventfd the UI thread writes to,
+// both watched by one epoll instance. The network thread always reads whatever the server sends,
+// even while it's waiting for the player, and wakes up as soon as either side has something.
+
+// Maximum amount of resolved addresses that are tried
+#define MAX_CONNECTION_ATTEMPTS 16
+
+int serverFd = -1;
+int epollFd = -1;
+int wakeFd = -1;
+
+void initTransport() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(epollFd < 0) {
+        fprintf(stderr, "Error: couldn't create epoll instance:\n%s\n", strerror(errno));
+        exit(1);
+    }
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(wakeFd < 0) {
+        fprintf(stderr, "Error: couldn't create eventfd:\n%s\n", strerror(errno));
+        exit(1);
+    }
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = wakeFd };
+    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) < 0) {
+        fprintf(stderr, "Error: couldn't watch eventfd:\n%s\n", strerror(errno));
+        exit(1);
+    }
+}
+
+// Waits until fd is ready for events (POLLIN or POLLOUT). Used outside of the epoll loop, for connecting and sending.
+void waitFd(int fd, short events) {
+    struct pollfd p = { .fd = fd, .events = events };
+    while(poll(&p, 1, -1) < 0) {
+        if(errno != EINTR) {
+            fprintf(stderr, "Error: couldn't wait for socket:\n%s\n", strerror(errno));
+            exit(1);
+        }
+    }
+}
+
+// Milliseconds on a monotonic clock.
+unsigned long getMilliseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long) ts.tv_sec * 1000 + (unsigned long) ts.tv_nsec / 1000000;
+}
+
+// Starts a non-blocking connection to ai and watches it for writability. Returns the socket, or -1 if it failed right away.
+int startConnectionAttempt(struct addrinfo* ai) {
+    int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+    if(fd < 0) return -1;
+    if(connect(fd, ai->ai_addr, ai->ai_addrlen) < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+    struct epoll_event ev = { .events = EPOLLOUT, .data.fd = fd };
+    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Resolves the server's address and connects to it, calling progress after each step.
+// This runs on the network thread, so the window never waits for it. All resolved addresses are raced
+// happy-eyeballs style (RFC 8305): families are interleaved, a new attempt starts every CONNECTION_ATTEMPT_DELAY ms
+// or as soon as the previous one fails, and the first connection to complete wins.
+void connectToServer(const char* address, long port, void (*progress)(const ConnectionTimings* timings)) {
+    ConnectionTimings timings;
+    memset(&timings, 0, sizeof(timings));
+    unsigned long start = getMilliseconds();
+
+    char portString[8];
+    snprintf(portString, sizeof(portString), "%ld", port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_ADDRCONFIG;
+    struct addrinfo* addresses;
+    int result = getaddrinfo(address, portString, &hints, &addresses);
+    if(result != 0) {
+        fprintf(stderr, "Error: couldn't resolve host:\n%s\n", gai_strerror(result));
+        exit(1);
+    }
+
+    // Interleave address families, starting with the one the resolver preferred
+    struct addrinfo* ordered[MAX_CONNECTION_ATTEMPTS];
+    int count = 0;
+    int firstFamily = addresses->ai_family;
+    struct addrinfo* preferred = addresses;
+    struct addrinfo* other = addresses;
+    while(count < MAX_CONNECTION_ATTEMPTS && (preferred != NULL || other != NULL)) {
+        while(preferred != NULL && preferred->ai_family != firstFamily) preferred = preferred->ai_next;
+        if(preferred != NULL) {
+            ordered[count++] = preferred;
+            preferred = preferred->ai_next;
+        }
+        while(other != NULL && other->ai_family == firstFamily) other = other->ai_next;
+        if(other != NULL && count < MAX_CONNECTION_ATTEMPTS) {
+            ordered[count++] = other;
+            other = other->ai_next;
+        }
+    }
+
+    timings.stage = RACING;
+    timings.addressCount = count;
+    timings.resolveMs = getMilliseconds() - start;
+    progress(&timings);
+
+    start = getMilliseconds();
+    int attemptFds[MAX_CONNECTION_ATTEMPTS];
+    int next = 0, pending = 0;
+    while(serverFd < 0) {
+        // Start the next attempt if it's due or nothing else is in flight
+        if(pending == 0 || (next < count && getMilliseconds() - start >= (unsigned long) next * CONNECTION_ATTEMPT_DELAY)) {
+            if(next == count) break; // Every address failed
+            attemptFds[next] = startConnectionAttempt(ordered[next]);
+            if(attemptFds[next] >= 0) pending++;
+            next++;
+            timings.attempts = next;
+            continue;
+        }
+
+        int timeout = -1;
+        if(next < count) {
+            unsigned long due = start + (unsigned long) next * CONNECTION_ATTEMPT_DELAY;
+            unsigned long now = getMilliseconds();
+            timeout = due > now ? (int) (due - now) : 0;
+        }
+        struct epoll_event events[MAX_CONNECTION_ATTEMPTS];
+        int ready = epoll_wait(epollFd, events, MAX_CONNECTION_ATTEMPTS, timeout);
+        if(ready < 0 && errno != EINTR) {
+            fprintf(stderr, "Error: couldn't wait for connection attempts:\n%s\n", strerror(errno));
+            exit(1);
+        }
+        for(int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if(fd == wakeFd) { // Client signals are only looked at once connected; waitForClientSignal checks clientInfo first
+                uint64_t value;
+                while(read(wakeFd, &value, sizeof(value)) > 0);
+                continue;
+            }
+            int error = 0;
+            socklen_t errorLength = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLength);
+            for(int j = 0; j < next; j++) {
+                if(attemptFds[j] != fd) continue;
+                if(error == 0 && serverFd < 0) {
+                    serverFd = fd;
+                    getnameinfo(ordered[j]->ai_addr, ordered[j]->ai_addrlen, timings.address, sizeof(timings.address), NULL, 0, NI_NUMERICHOST);
+                }
+                else {
+                    close(fd);
+                    pending--;
+                }
+                attemptFds[j] = -1;
+            }
+        }
+    }
+    // Drop the attempts that lost the race
+    for(int j = 0; j < next; j++) {
+        if(attemptFds[j] >= 0) close(attemptFds[j]);
+    }
+    freeaddrinfo(addresses);
+    if(serverFd < 0) {
+        fprintf(stderr, "Error: couldn't connect to server: every address failed.\n");
+        exit(1);
+    }
+
+    int noDelay = 1; // Messages are tiny and each one waits for an answer: don't let Nagle hold them back
+    setsockopt(serverFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP, .data.fd = serverFd };
+    if(epoll_ctl(epollFd, EPOLL_CTL_MOD, serverFd, &ev) < 0) {
+        fprintf(stderr, "Error: couldn't watch server socket:\n%s\n", strerror(errno));
+        exit(1);
+    }
+
+    timings.stage = CONNECTED;
+    timings.connectMs = getMilliseconds() - start;
+    progress(&timings);
+}
+
+void sendToServer(const char* data, size_t length) {
+    while(length > 0) {
+        ssize_t sent = send(serverFd, data, length, MSG_NOSIGNAL);
+        if(sent < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                waitFd(serverFd, POLLOUT);
+                continue;
+            }
+            if(errno == EINTR) continue;
+            fprintf(stderr, "Error: couldn't send message to server:\n%s\n", strerror(errno));
+            exit(1);
+        }
+        data += sent;
+        length -= (size_t) sent;
+    }
+}
+
+// Reads everything the server has sent so far into framer.
+void drainServerSocket(MessageFramer* framer) {
+    for(;;) {
+        size_t available;
+        char* buf = getFramerWriteSpace(framer, &available);
+        ssize_t result = recv(serverFd, buf, available, 0);
+        if(result < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) return;
+            if(errno == EINTR) continue;
+            fprintf(stderr, "Error: couldn't receive from server:\n%s\n", strerror(errno));
+            exit(1);
+        }
+        else if(result == 0) {
+            printf("Server closed connection.\n");
+            exit(1);
+        }
+        commitFramerWrite(framer, (size_t) result);
+    }
+}
+
+// Blocks until the server sends something (which is appended to framer) or, if wakeable, until wakeTransport is called.
+// Returns TRANSPORT_RECEIVED or TRANSPORT_WOKEN; if both happened, data is read first and TRANSPORT_WOKEN is returned.
+int waitTransport(MessageFramer* framer, unsigned char wakeable) {
+    for(;;) {
+        struct epoll_event events[2];
+        int count = epoll_wait(epollFd, events, 2, -1);
+        if(count < 0) {
+            if(errno == EINTR) continue;
+            fprintf(stderr, "Error: couldn't wait for network events:\n%s\n", strerror(errno));
+            exit(1);
+        }
+
+        int result = 0;
+        for(int i = 0; i < count; i++) {
+            if(events[i].data.fd == serverFd) {
+                drainServerSocket(framer);
+                if(result == 0) result = TRANSPORT_RECEIVED;
+            }
+            else if(events[i].data.fd == wakeFd) {
+                uint64_t value;
+                while(read(wakeFd, &value, sizeof(value)) > 0); // Reset the counter
+                if(wakeable) result = TRANSPORT_WOKEN;
+            }
+        }
+        if(result != 0) return result;
+    }
+}
+
+// Wakes up a waitTransport call in the network thread. Safe to call from any thread.
+void wakeTransport() {
+    uint64_t one = 1;
+    if(write(wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        fprintf(stderr, "Error: couldn't wake network thread:\n%s\n", strerror(errno));
+        exit(1);
+    }
+}
+
+void closeTransport() {
+    if(serverFd >= 0) close(serverFd);
+    close(wakeFd);
+    close(epollFd);
+    serverFd = -1;
+}
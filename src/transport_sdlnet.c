@@ -0,0 +1,81 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_net.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "transport.h"
+
+// Portable transport built on SDL_net. Receiving blocks, so it can't be woken up by the UI thread:
+// the network thread waits for client signals on networkState.clientSignal instead.
+
+IPaddress serverIpAddress;
+TCPsocket serverSocket;
+
+void initTransport() {
+    if(SDLNet_Init() != 0) {
+        fprintf(stderr, "Error: couldn't initialize SDLNet:\n%s\n", SDLNet_GetError());
+        exit(1);
+    }
+}
+
+// Resolves the server's address and connects to it, calling progress after each step.
+// SDL_net only resolves a single IPv4 address, so there's nothing to race.
+void connectToServer(const char* address, long port, void (*progress)(const ConnectionTimings* timings)) {
+    ConnectionTimings timings;
+    memset(&timings, 0, sizeof(timings));
+    Uint32 start = SDL_GetTicks();
+
+    if(SDLNet_ResolveHost(&serverIpAddress, address, (Uint16) port) != 0) {
+        fprintf(stderr, "Error: couldn't resolve host:\n%s\n", SDLNet_GetError());
+        exit(1);
+    }
+    timings.stage = RACING;
+    timings.addressCount = 1;
+    timings.attempts = 1;
+    timings.resolveMs = SDL_GetTicks() - start;
+    progress(&timings);
+
+    start = SDL_GetTicks();
+    serverSocket = SDLNet_TCP_Open(&serverIpAddress);
+    if(!serverSocket) {
+        fprintf(stderr, "Error: couldn't connect to server:\n%s\n", SDLNet_GetError());
+        exit(1);
+    }
+    Uint8* host = (Uint8*) &serverIpAddress.host;
+    snprintf(timings.address, sizeof(timings.address), "%d.%d.%d.%d", host[0], host[1], host[2], host[3]);
+    timings.stage = CONNECTED;
+    timings.connectMs = SDL_GetTicks() - start;
+    progress(&timings);
+}
+
+void sendToServer(const char* data, size_t length) {
+    if(SDLNet_TCP_Send(serverSocket, data, (int) length) < (int) length) {
+        fprintf(stderr, "Error: couldn't send message to server:\n%s\n", SDLNet_GetError());
+        exit(1);
+    }
+}
+
+// Blocks until the server sends something and appends it to framer.
+int waitTransport(MessageFramer* framer, unsigned char wakeable) {
+    size_t available;
+    char* buf = getFramerWriteSpace(framer, &available);
+    int result = SDLNet_TCP_Recv(serverSocket, buf, (int) available);
+    if(result < 0) {
+        fprintf(stderr, "Error: couldn't receive from server:\n%s\n", SDLNet_GetError());
+        exit(1);
+    }
+    else if(result == 0) {
+        printf("Server closed connection.\n");
+        exit(1);
+    }
+    commitFramerWrite(framer, (size_t) result);
+    return TRANSPORT_RECEIVED;
+}
+
+void wakeTransport() {
+}
+
+void closeTransport() {
+    SDLNet_TCP_Close(serverSocket);
+    SDLNet_Quit();
+}